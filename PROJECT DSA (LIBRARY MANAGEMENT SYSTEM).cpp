@@ -1,16 +1,263 @@
+#include <stdarg.h>
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 #include <unistd.h> 
 
+#ifdef __linux__
+#include <errno.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#define LOAN_BORROW 0
+#define LOAN_RETURN 1
+#define REPORT_TOP_N 10
+#define LOAN_START_UNKNOWN -1
+#define OPEN_LOAN_EMPTY 0
+#define OPEN_LOAN_USED 1
+#define OPEN_LOAN_DELETED 2
+#define JOURNAL_CHECKPOINT_ENTRIES 1024
+#define REPORT_MAX_THREADS 8
+#define REPORT_ROWS_PER_THREAD 1000000
+#define REPORT_DENSE_LIMIT (1 << 20)
+
+#define LISTING_ALL 0
+#define LISTING_AVAILABLE 1
+#define LISTING_CACHE_SLOTS 8
+#define LISTING_CACHE_BUDGET (4 * 1024 * 1024)
+
+#define MAX_BRANCHES 64
+#define MAX_PATH_LENGTH 128
+
+#define MAX_USER_TYPES 8
+#define BITMAP_CHUNK_WORDS 1024
+#define BITMAP_ARRAY_LIMIT 4096
+#define BITMAP_SIGN_BIAS 0x80000000u
+
+#define SEARCH_TOP_K 10
+#define SEARCH_MAX_PATTERN 64
+#define SEARCH_BIGRAMS 4096
+#define SEARCH_REBUILD_MIN 1024
+
+#define SERVER_MAX_EVENTS 256
+#define SERVER_LINE_LENGTH 512
+#define SERVER_OUTPUT_HIGH_WATER (1 << 20)
+#define SERVER_OUTPUT_LOW_WATER (256 << 10)
+#define SERVER_OUTPUT_LIMIT (4 << 20)
+#define LOGIN_FAILURE_DELAY_MS 2000
+
+#define THROTTLE_SLOTS 4096
+#define THROTTLE_PROBES 8
+#define LOGIN_BURST 5
+#define LOGIN_REFILL_SECONDS 30
+
+#define BACKUP_SECTIONS 4
+#define BACKUP_BLOCK_SIZE 65536
+#define BACKUP_MAGIC "LMSBAK1"
+
 
 typedef struct Book {
+    int id;
+    unsigned int titleHandle;
+    unsigned int authorHandle;
+    int isBorrowed;
+    unsigned int searchSlot;
+    struct Book* next;
+    struct Book* hashNext;
+} Book;
+
+
+typedef struct BookFileRecord {
     int id;
     char title[100];
     char author[100];
     int isBorrowed;
     struct Book* next;
-} Book;
+} BookFileRecord;
+
+
+typedef struct JournalRecord {
+    int type;
+    int bookId;
+    int userId;
+    char dueDate[20];
+} JournalRecord;
+
+
+typedef struct BranchCatalog {
+    BookFileRecord* books;
+    int count;
+} BranchCatalog;
+
+
+typedef struct LoanEventRecord {
+    int bookId;
+    int userId;
+    int type;
+    long long time;
+    long long loanStart;
+} LoanEventRecord;
+
+
+typedef struct OpenLoan {
+    int bookId;
+    int userId;
+    long long start;
+    int state;
+} OpenLoan;
+
+
+typedef struct LoanHistory {
+    int* bookIds;
+    int* userIds;
+    int* types;
+    long long* times;
+    long long* loanStarts;
+    int count;
+    int capacity;
+    int minBookId, maxBookId;
+    int minUserId, maxUserId;
+} LoanHistory;
+
+
+typedef struct ByteBuffer {
+    unsigned char* data;
+    size_t length;
+    size_t capacity;
+} ByteBuffer;
+
+
+typedef struct BackupBlockHeader {
+    unsigned int rawLength;
+    unsigned int packedLength;
+    unsigned int checksum;
+} BackupBlockHeader;
+
+
+typedef struct IdCount {
+    int id;
+    int count;
+} IdCount;
+
+
+typedef struct IdCounter {
+    IdCount* slots;
+    unsigned int capacity;
+    int distinct;
+    int* dense;
+    int base;
+    unsigned int span;
+} IdCounter;
+
+
+typedef struct ReportScan {
+    int firstRow;
+    int lastRow;
+    int hasFrom, hasTo;
+    long long from, to;
+    IdCounter books;
+    IdCounter users;
+    int loans;
+    int returns;
+    int timedReturns;
+    long long totalDuration;
+    int ok;
+} ReportScan;
+
+
+typedef struct ListingPage {
+    int view;
+    int rows;
+    unsigned long version;
+    unsigned long lastUsed;
+    char* text;
+    size_t length;
+    size_t capacity;
+} ListingPage;
+
+
+typedef struct AuthorEntry {
+    char* name;
+    unsigned int hash;
+    int bookCount;
+    int availableCount;
+} AuthorEntry;
+
+
+typedef struct UserTypeStat {
+    char type[20];
+    int users;
+    int borrowed;
+} UserTypeStat;
+
+
+typedef struct SearchMatch {
+    Book* book;
+    int distance;
+} SearchMatch;
+
+
+typedef struct NetworkMatch {
+    char branch[32];
+    BookFileRecord book;
+    int distance;
+} NetworkMatch;
+
+
+typedef struct SearchPattern {
+    unsigned long long peq[256];
+    unsigned char bigrams[SEARCH_BIGRAMS];
+    int length;
+    int distinctBigrams;
+    int maxErrors;
+} SearchPattern;
+
+
+typedef struct PostingList {
+    unsigned int* slots;
+    int count;
+    int capacity;
+} PostingList;
+
+
+typedef struct TokenBucket {
+    unsigned int hash;
+    char key[50];
+    int tokens;
+    long long updatedAt;
+} TokenBucket;
+
+
+typedef struct ClientSession {
+    int fd;
+    int userId;
+    char clientKey[32];
+    char input[SERVER_LINE_LENGTH];
+    size_t inputLength;
+    ListingPage output;
+    int throttled;
+    int closing;
+    Book** pendingBooks;
+    int pendingCount;
+    int pendingNext;
+    long long resumeAt;
+    struct ClientSession* nextDelayed;
+} ClientSession;
+
+
+typedef struct BitmapChunk {
+    unsigned int key;
+    int count;
+    int capacity;
+    unsigned short* values;
+    unsigned long long* bits;
+} BitmapChunk;
 
 
 typedef struct User {
@@ -36,18 +283,116 @@ Book* head = NULL;
 User* userHead = NULL;
 BorrowRecord* recordHead = NULL;
 
+AuthorEntry* authorTable = NULL;
+unsigned int authorCount = 0;
+unsigned int authorCapacity = 0;
+unsigned int* authorBuckets = NULL;
+unsigned int authorBucketCount = 0;
+
+OpenLoan* openLoans = NULL;
+unsigned int openLoanCapacity = 0;
+unsigned int openLoanCount = 0;
+unsigned int openLoanDeleted = 0;
+
+LoanHistory history = { NULL, NULL, NULL, NULL, NULL, 0, 0, 0, 0, 0, 0 };
+
+ListingPage listingCache[LISTING_CACHE_SLOTS];
+size_t listingCacheBytes = 0;
+unsigned long listingCacheClock = 0;
+unsigned long listingCacheHits = 0;
+unsigned long listingCacheMisses = 0;
+unsigned long catalogVersion = 1;
+
+Book** bookBuckets = NULL;
+unsigned int bookBucketCount = 0;
+
+int totalBooks = 0;
+int availableBooks = 0;
+int borrowedBooks = 0;
+
+UserTypeStat userTypeStats[MAX_USER_TYPES];
+int userTypeCount = 0;
+
+TokenBucket usernameBuckets[THROTTLE_SLOTS];
+TokenBucket clientBuckets[THROTTLE_SLOTS];
+
+PostingList searchPostings[SEARCH_BIGRAMS];
+Book** searchBooks = NULL;
+unsigned char* searchCounts = NULL;
+unsigned int searchBookCount = 0;
+unsigned int searchBookCapacity = 0;
+unsigned int searchDeadCount = 0;
+
+BitmapChunk** availableChunks = NULL;
+int availableChunkCount = 0;
+int availableChunkCapacity = 0;
+
+char* titlePool = NULL;
+unsigned int titlePoolUsed = 0;
+unsigned int titlePoolSize = 0;
+unsigned int titlePoolWasted = 0;
+
 int loggedInUserId = -1;
 char loggedInUserType[20] = "";
 char loggedInUsername[50] = "";
 char loggedInName[100] = "";
 
-const char* USER_FILE = "users.dat";
-const char* BOOK_FILE = "books.dat";
-const char* BORROW_FILE = "borrow_records.dat";
+const char* DEFAULT_BRANCH = "main";
+const char* BRANCH_FILE = "branches.txt";
+const char* DEFAULT_BACKUP_FILE = "library_backup.lbk";
+
+char branchName[32] = "main";
+char USER_FILE[MAX_PATH_LENGTH] = "users.dat";
+char BOOK_FILE[MAX_PATH_LENGTH] = "books.dat";
+char BORROW_FILE[MAX_PATH_LENGTH] = "borrow_records.dat";
+char HISTORY_FILE[MAX_PATH_LENGTH] = "loan_history.dat";
+char JOURNAL_FILE[MAX_PATH_LENGTH] = "loan_journal.dat";
+int journalEntries = 0;
 
-void saveUsersToFile();
-void saveBooksToFile();
-void saveBorrowRecordsToFile();
+unsigned int hashString(const char* str);
+unsigned int internAuthor(const char* name);
+const char* authorName(unsigned int handle);
+unsigned int storeTitle(const char* title);
+void releaseTitle(unsigned int handle);
+void compactTitlePool();
+const char* bookTitle(const Book* book);
+const char* bookAuthor(const Book* book);
+void recordLoanEvent(int type, int bookId, int userId, long long loanStart);
+long long findLoanStart(int bookId, int userId);
+void loadLoanHistoryFromFile();
+void showCirculationReports();
+int printListing(int view);
+void clearListingCache();
+int selectBranch(const char* name);
+void displayNetworkCatalog();
+void trackBook(Book* book);
+void untrackBook(Book* book);
+void setBookBorrowed(Book* book, int borrowed);
+void resetCatalogIndexes();
+int firstAvailableBooks(int* ids, int limit);
+UserTypeStat* userTypeStat(const char* type);
+void recountUserTypes();
+void indexBookText(Book* book);
+void unindexBookText(Book* book);
+void clearSearchIndex();
+int findBooksByText(const char* query, SearchMatch* matches);
+int findBooksAcrossBranches(const char* query, NetworkMatch* matches);
+void searchBooksByText();
+User* findUserById(int id);
+User* findUserByCredentials(const char* username, const char* password);
+int loginRetryAfter(const char* username, const char* clientKey);
+void recordLoginFailure(const char* username, const char* clientKey);
+int borrowBookForUser(User* user, Book* book, const char* dueDate);
+int returnBookForUser(int userId, Book* book);
+void backupLibraryData();
+void restoreLibraryData();
+void initializeProgramData();
+int saveUsersToFile();
+int saveBooksToFile();
+int saveBorrowRecordsToFile();
+void journalLoanChange(int type, int bookId, int userId, const char* dueDate);
+void replayLoanJournal();
+int checkpointLibraryData();
 void loadUsersFromFile();
 void loadBooksFromFile();
 void loadBorrowRecordsFromFile();
@@ -74,665 +419,3415 @@ void clearScreen() {
     #endif
 }
 
-void displayMainMenu() {
-    clearScreen();
-    
-    printf("Login successful! Welcome, %s.\n\n", loggedInUsername);
-    printf("===== Library Management System =====\n");
-    printf("Logged in as: %s (%s)\n", loggedInName, loggedInUserType);
-    
-    if (strcmp(loggedInUserType, "Faculty") == 0) {
-        printf("\n--- Admin Functions ---\n");
-        printf("1. Add New Book\n");
-        printf("2. Edit Book\n");
-        printf("3. Delete Book\n");
+unsigned int hashString(const char* str) {
+    unsigned int hash = 2166136261u;
+    while (*str) {
+        hash ^= (unsigned char)*str++;
+        hash *= 16777619u;
     }
-    
-    printf("\n--- Book Functions ---\n");
-    printf("4. View All Books\n");
-    printf("5. Borrow a Book\n");
-    printf("6. Return a Book\n");
-    printf("7. View My Borrowed Books\n");
-    
-    printf("\n--- Account Functions ---\n");
-    printf("8. View My Account\n");
-    printf("9. Logout\n");
-    printf("10. Exit\n");
-    
-    printf("Enter your choice: ");
+    return hash;
 }
 
-void addBook(int id, char* title, char* author) {
-    Book* newBook = (Book*)malloc(sizeof(Book));
-    if (!newBook) {
-        printf("Memory allocation failed!\n");
-        return;
+unsigned int internAuthor(const char* name) {
+    unsigned int hash = hashString(name);
+    unsigned int i;
+    
+    if ((authorCount + 1) * 2 > authorBucketCount) {
+        unsigned int newCount = authorBucketCount ? authorBucketCount * 2 : 64;
+        unsigned int* newBuckets = (unsigned int*)calloc(newCount, sizeof(unsigned int));
+        if (!newBuckets) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        for (unsigned int h = 0; h < authorCount; h++) {
+            i = authorTable[h].hash & (newCount - 1);
+            while (newBuckets[i])
+                i = (i + 1) & (newCount - 1);
+            newBuckets[i] = h + 1;
+        }
+        free(authorBuckets);
+        authorBuckets = newBuckets;
+        authorBucketCount = newCount;
     }
     
-    newBook->id = id;
-    strcpy(newBook->title, title);
-    strcpy(newBook->author, author);
-    newBook->isBorrowed = 0;
-    newBook->next = head;
-    head = newBook;
+    i = hash & (authorBucketCount - 1);
+    while (authorBuckets[i]) {
+        AuthorEntry* entry = &authorTable[authorBuckets[i] - 1];
+        if (entry->hash == hash && strcmp(entry->name, name) == 0)
+            return authorBuckets[i] - 1;
+        i = (i + 1) & (authorBucketCount - 1);
+    }
     
-    clearScreen();
-    displayMainMenu();
-    printf("\nBook added successfully!\n");
+    if (authorCount == authorCapacity) {
+        unsigned int newCapacity = authorCapacity ? authorCapacity * 2 : 32;
+        AuthorEntry* newTable = (AuthorEntry*)realloc(authorTable, newCapacity * sizeof(AuthorEntry));
+        if (!newTable) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        authorTable = newTable;
+        authorCapacity = newCapacity;
+    }
     
-    saveBooksToFile();
+    char* copy = (char*)malloc(strlen(name) + 1);
+    if (!copy) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    strcpy(copy, name);
+    
+    authorTable[authorCount].name = copy;
+    authorTable[authorCount].hash = hash;
+    authorTable[authorCount].bookCount = 0;
+    authorTable[authorCount].availableCount = 0;
+    authorBuckets[i] = authorCount + 1;
+    return authorCount++;
 }
 
-void displayBooks() {
-    Book* temp = head;
-    
-    clearScreen();
-    displayMainMenu();
+const char* authorName(unsigned int handle) {
+    return handle < authorCount ? authorTable[handle].name : "";
+}
+
+unsigned int storeTitle(const char* title) {
+    unsigned int length = strlen(title) + 1;
+    
+    if (titlePoolUsed + length > titlePoolSize) {
+        unsigned int newSize = titlePoolSize ? titlePoolSize : 4096;
+        while (titlePoolUsed + length > newSize)
+            newSize *= 2;
+        char* newPool = (char*)realloc(titlePool, newSize);
+        if (!newPool) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        titlePool = newPool;
+        titlePoolSize = newSize;
+    }
     
-    if (!temp) {
-        printf("\nNo books in the library.\n");
+    unsigned int handle = titlePoolUsed;
+    memcpy(titlePool + handle, title, length);
+    titlePoolUsed += length;
+    return handle;
+}
+
+void releaseTitle(unsigned int handle) {
+    titlePoolWasted += strlen(titlePool + handle) + 1;
+}
+
+void compactTitlePool() {
+    if (titlePoolWasted < 4096 || titlePoolWasted * 2 < titlePoolUsed)
         return;
-    }
     
-    printf("\nLibrary Books:\n");
-    printf("%-5s %-40s %-30s %-10s\n", "ID", "Title", "Author", "Status");
-    printf("------------------------------------------------------------------\n");
+    char* newPool = (char*)malloc(titlePoolSize);
+    if (!newPool)
+        return;
     
+    unsigned int used = 0;
+    Book* temp = head;
     while (temp) {
-        printf("%-5d %-40s %-30s %-10s\n", 
-               temp->id, temp->title, temp->author, 
-               temp->isBorrowed ? "Borrowed" : "Available");
+        unsigned int length = strlen(titlePool + temp->titleHandle) + 1;
+        memcpy(newPool + used, titlePool + temp->titleHandle, length);
+        temp->titleHandle = used;
+        used += length;
         temp = temp->next;
     }
+    
+    free(titlePool);
+    titlePool = newPool;
+    titlePoolUsed = used;
+    titlePoolWasted = 0;
 }
 
-Book* searchBook(int id) {
-    Book* temp = head;
-    while (temp) {
-        if (temp->id == id)
-            return temp;
-        temp = temp->next;
-    }
-    return NULL;
+const char* bookTitle(const Book* book) {
+    return titlePool + book->titleHandle;
 }
 
-void deleteBook(int id) {
-    Book *temp = head, *prev = NULL;
-    
-    while (temp && temp->id != id) {
-        prev = temp;
-        temp = temp->next;
+const char* bookAuthor(const Book* book) {
+    return authorName(book->authorHandle);
+}
+
+unsigned int bookSlot(int id) {
+    return ((unsigned int)id * 2654435761u) & (bookBucketCount - 1);
+}
+
+void indexBook(Book* book) {
+    if ((unsigned int)totalBooks + 1 > bookBucketCount) {
+        unsigned int oldCount = bookBucketCount;
+        Book** oldBuckets = bookBuckets;
+        unsigned int newCount = bookBucketCount ? bookBucketCount * 2 : 256;
+        Book** newBuckets = (Book**)calloc(newCount, sizeof(Book*));
+        if (!newBuckets) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        
+        bookBuckets = newBuckets;
+        bookBucketCount = newCount;
+        for (unsigned int i = 0; i < oldCount; i++) {
+            Book* temp = oldBuckets[i];
+            while (temp) {
+                Book* next = temp->hashNext;
+                unsigned int slot = bookSlot(temp->id);
+                temp->hashNext = bookBuckets[slot];
+                bookBuckets[slot] = temp;
+                temp = next;
+            }
+        }
+        free(oldBuckets);
     }
     
-    clearScreen();
-    displayMainMenu();
-    
-    if (!temp) {
-        printf("\nBook not found!\n");
-        return;
+    unsigned int slot = bookSlot(book->id);
+    book->hashNext = bookBuckets[slot];
+    bookBuckets[slot] = book;
+}
+
+void unindexBook(Book* book) {
+    Book** link = &bookBuckets[bookSlot(book->id)];
+    while (*link && *link != book)
+        link = &(*link)->hashNext;
+    if (*link)
+        *link = book->hashNext;
+}
+
+int locateAvailableChunk(unsigned int key) {
+    int low = 0, high = availableChunkCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (availableChunks[mid]->key < key)
+            low = mid + 1;
+        else
+            high = mid;
     }
-    
-    if (temp->isBorrowed) {
-        printf("\nCannot delete a book that is currently borrowed!\n");
-        return;
+    return low;
+}
+
+BitmapChunk* insertAvailableChunk(int position, unsigned int key) {
+    if (availableChunkCount == availableChunkCapacity) {
+        int newCapacity = availableChunkCapacity ? availableChunkCapacity * 2 : 8;
+        BitmapChunk** newChunks = (BitmapChunk**)realloc(availableChunks, newCapacity * sizeof(BitmapChunk*));
+        if (!newChunks) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        availableChunks = newChunks;
+        availableChunkCapacity = newCapacity;
     }
     
-    if (prev)
-        prev->next = temp->next;
-    else
-        head = temp->next;
-    free(temp);
-    printf("\nBook deleted successfully!\n");
+    BitmapChunk* chunk = (BitmapChunk*)calloc(1, sizeof(BitmapChunk));
+    if (!chunk) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    chunk->key = key;
     
-    saveBooksToFile();
+    memmove(&availableChunks[position + 1], &availableChunks[position], 
+            (availableChunkCount - position) * sizeof(BitmapChunk*));
+    availableChunks[position] = chunk;
+    availableChunkCount++;
+    return chunk;
 }
 
-void editBook(int id) {
-    Book* book = searchBook(id);
+void freeAvailableChunk(BitmapChunk* chunk) {
+    free(chunk->values);
+    free(chunk->bits);
+    free(chunk);
+}
+
+void convertChunkToBitset(BitmapChunk* chunk) {
+    unsigned long long* bits = (unsigned long long*)calloc(BITMAP_CHUNK_WORDS, sizeof(unsigned long long));
+    if (!bits) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
     
-    clearScreen();
-    displayMainMenu();
+    for (int i = 0; i < chunk->count; i++)
+        bits[chunk->values[i] >> 6] |= 1ULL << (chunk->values[i] & 63);
     
-    if (!book) {
-        printf("\nBook not found!\n");
+    free(chunk->values);
+    chunk->values = NULL;
+    chunk->capacity = 0;
+    chunk->bits = bits;
+}
+
+void convertChunkToArray(BitmapChunk* chunk) {
+    unsigned short* values = (unsigned short*)malloc(chunk->count * sizeof(unsigned short));
+    if (!values)
         return;
-    }
     
-    if (book->isBorrowed) {
-        printf("\nCannot edit a book that is currently borrowed!\n");
-        return;
+    int count = 0;
+    for (int w = 0; w < BITMAP_CHUNK_WORDS; w++) {
+        unsigned long long word = chunk->bits[w];
+        while (word) {
+            values[count++] = (unsigned short)((w << 6) | __builtin_ctzll(word));
+            word &= word - 1;
+        }
     }
     
-    printf("\nEnter new title (current: %s): ", book->title);
-    getchar();
-    fgets(book->title, sizeof(book->title), stdin);
-    book->title[strcspn(book->title, "\n")] = 0;
-    
-    printf("Enter new author (current: %s): ", book->author);
-    fgets(book->author, sizeof(book->author), stdin);
-    book->author[strcspn(book->author, "\n")] = 0;
-    
-    printf("\nBook details updated successfully!\n");
-    
-    saveBooksToFile();
+    free(chunk->bits);
+    chunk->bits = NULL;
+    chunk->values = values;
+    chunk->capacity = chunk->count;
 }
 
-User* getLoggedInUser() {
-    User* temp = userHead;
-    while (temp) {
-        if (temp->id == loggedInUserId)
-            return temp;
-        temp = temp->next;
+int markInArrayChunk(BitmapChunk* chunk, unsigned short low, int available) {
+    int first = 0, last = chunk->count;
+    while (first < last) {
+        int mid = (first + last) / 2;
+        if (chunk->values[mid] < low)
+            first = mid + 1;
+        else
+            last = mid;
     }
-    return NULL;
-}
-
-int loginUser() {
-    char username[50], password[50];
     
-    clearScreen();
-    printf("===== Library Management System =====\n");
-    printf("\n===== User Login =====\n");
-    printf("Enter Username: ");
-    fgets(username, sizeof(username), stdin);
-    username[strcspn(username, "\n")] = 0;
+    int present = first < chunk->count && chunk->values[first] == low;
+    if (available == present)
+        return 0;
     
-    printf("Enter Password: ");
-    fgets(password, sizeof(password), stdin);
-    password[strcspn(password, "\n")] = 0;
+    if (!available) {
+        memmove(&chunk->values[first], &chunk->values[first + 1], 
+                (chunk->count - first - 1) * sizeof(unsigned short));
+        chunk->count--;
+        return 1;
+    }
     
-    User* temp = userHead;
-    while (temp) {
-        if (strcmp(temp->username, username) == 0 && strcmp(temp->password, password) == 0) {
-            loggedInUserId = temp->id;
-            strcpy(loggedInUserType, temp->type);
-            strcpy(loggedInUsername, temp->username);
-            strcpy(loggedInName, temp->name);
-            
-            displayMainMenu();
-            return 1;
+    if (chunk->count == chunk->capacity) {
+        int newCapacity = chunk->capacity ? chunk->capacity * 2 : 4;
+        unsigned short* newValues = (unsigned short*)realloc(chunk->values, newCapacity * sizeof(unsigned short));
+        if (!newValues) {
+            printf("Memory allocation failed!\n");
+            exit(1);
         }
-        temp = temp->next;
+        chunk->values = newValues;
+        chunk->capacity = newCapacity;
     }
     
-    printf("\nInvalid username or password. Please try again.\n");
-    sleep(2);
-    return 0;
+    memmove(&chunk->values[first + 1], &chunk->values[first], 
+            (chunk->count - first) * sizeof(unsigned short));
+    chunk->values[first] = low;
+    chunk->count++;
+    return 1;
 }
 
-void logoutUser() {
-    if (loggedInUserId == -1) {
-        printf("\nNo user is currently logged in.\n");
+void markAvailable(int id, int available) {
+    unsigned int value = (unsigned int)id ^ BITMAP_SIGN_BIAS;
+    unsigned int key = value >> 16;
+    int position = locateAvailableChunk(key);
+    
+    BitmapChunk* chunk = NULL;
+    if (position < availableChunkCount && availableChunks[position]->key == key)
+        chunk = availableChunks[position];
+    else if (available)
+        chunk = insertAvailableChunk(position, key);
+    else
         return;
+    
+    if (chunk->bits) {
+        unsigned long long* word = &chunk->bits[(value & 0xFFFF) >> 6];
+        unsigned long long mask = 1ULL << (value & 63);
+        if (available && !(*word & mask)) {
+            *word |= mask;
+            chunk->count++;
+        } else if (!available && (*word & mask)) {
+            *word &= ~mask;
+            chunk->count--;
+        }
+    } else {
+        markInArrayChunk(chunk, (unsigned short)(value & 0xFFFF), available);
+        if (chunk->count > BITMAP_ARRAY_LIMIT)
+            convertChunkToBitset(chunk);
     }
     
-    loggedInUserId = -1;
-    strcpy(loggedInUserType, "");
-    strcpy(loggedInUsername, "");
+    if (chunk->count == 0) {
+        freeAvailableChunk(chunk);
+        memmove(&availableChunks[position], &availableChunks[position + 1], 
+                (availableChunkCount - position - 1) * sizeof(BitmapChunk*));
+        availableChunkCount--;
+    } else if (chunk->bits && chunk->count <= BITMAP_ARRAY_LIMIT / 2) {
+        convertChunkToArray(chunk);
+    }
+}
+
+int firstAvailableBooks(int* ids, int limit) {
+    int found = 0;
+    
+    for (int c = 0; c < availableChunkCount && found < limit; c++) {
+        BitmapChunk* chunk = availableChunks[c];
+        
+        if (!chunk->bits) {
+            for (int i = 0; i < chunk->count && found < limit; i++)
+                ids[found++] = (int)(((chunk->key << 16) | chunk->values[i]) ^ BITMAP_SIGN_BIAS);
+            continue;
+        }
+        
+        int remaining = chunk->count;
+        for (int w = 0; w < BITMAP_CHUNK_WORDS && remaining > 0 && found < limit; w++) {
+            unsigned long long word = chunk->bits[w];
+            while (word && found < limit) {
+                unsigned int bit = (unsigned int)__builtin_ctzll(word);
+                ids[found++] = (int)(((chunk->key << 16) | ((unsigned int)w << 6) | bit) ^ BITMAP_SIGN_BIAS);
+                word &= word - 1;
+                remaining--;
+            }
+        }
+    }
+    return found;
+}
+
+void trackBook(Book* book) {
+    AuthorEntry* author = &authorTable[book->authorHandle];
+    
+    indexBook(book);
+    indexBookText(book);
+    totalBooks++;
+    author->bookCount++;
+    if (book->isBorrowed) {
+        borrowedBooks++;
+    } else {
+        availableBooks++;
+        author->availableCount++;
+        markAvailable(book->id, 1);
+    }
+}
+
+void untrackBook(Book* book) {
+    AuthorEntry* author = &authorTable[book->authorHandle];
+    
+    unindexBook(book);
+    unindexBookText(book);
+    totalBooks--;
+    author->bookCount--;
+    if (book->isBorrowed) {
+        borrowedBooks--;
+    } else {
+        availableBooks--;
+        author->availableCount--;
+        markAvailable(book->id, 0);
+    }
+}
+
+void setBookBorrowed(Book* book, int borrowed) {
+    if (book->isBorrowed == borrowed)
+        return;
+    
+    int delta = borrowed ? 1 : -1;
+    book->isBorrowed = borrowed;
+    borrowedBooks += delta;
+    availableBooks -= delta;
+    authorTable[book->authorHandle].availableCount -= delta;
+    markAvailable(book->id, !borrowed);
+    catalogVersion++;
+}
+
+void resetCatalogIndexes() {
+    if (bookBuckets)
+        memset(bookBuckets, 0, bookBucketCount * sizeof(Book*));
+    
+    for (int i = 0; i < availableChunkCount; i++)
+        freeAvailableChunk(availableChunks[i]);
+    availableChunkCount = 0;
+    clearSearchIndex();
+    
+    for (unsigned int i = 0; i < authorCount; i++) {
+        authorTable[i].bookCount = 0;
+        authorTable[i].availableCount = 0;
+    }
+    
+    totalBooks = 0;
+    availableBooks = 0;
+    borrowedBooks = 0;
+}
+
+UserTypeStat* userTypeStat(const char* type) {
+    for (int i = 0; i < userTypeCount; i++) {
+        if (strcmp(userTypeStats[i].type, type) == 0)
+            return &userTypeStats[i];
+    }
+    
+    if (userTypeCount == MAX_USER_TYPES)
+        return NULL;
+    
+    UserTypeStat* stat = &userTypeStats[userTypeCount++];
+    strncpy(stat->type, type, sizeof(stat->type) - 1);
+    stat->type[sizeof(stat->type) - 1] = 0;
+    stat->users = 0;
+    stat->borrowed = 0;
+    return stat;
+}
+
+void recountUserTypes() {
+    userTypeCount = 0;
+    
+    User* temp = userHead;
+    while (temp) {
+        UserTypeStat* stat = userTypeStat(temp->type);
+        if (stat) {
+            stat->users++;
+            stat->borrowed += temp->currentlyBorrowed;
+        }
+        temp = temp->next;
+    }
+}
+
+void appendListing(ListingPage* page, const char* format, ...) {
+    va_list args;
+    
+    while (1) {
+        size_t room = page->capacity - page->length;
+        va_start(args, format);
+        int written = vsnprintf(page->text ? page->text + page->length : NULL, room, format, args);
+        va_end(args);
+        
+        if (written < 0)
+            return;
+        if ((size_t)written < room) {
+            page->length += written;
+            return;
+        }
+        
+        size_t newCapacity = page->capacity ? page->capacity * 2 : 4096;
+        while (newCapacity - page->length <= (size_t)written)
+            newCapacity *= 2;
+        char* newText = (char*)realloc(page->text, newCapacity);
+        if (!newText) {
+            printf("Memory allocation failed!\n");
+            return;
+        }
+        page->text = newText;
+        page->capacity = newCapacity;
+    }
+}
+
+void renderListing(ListingPage* page) {
+    Book* temp = head;
+    
+    page->rows = 0;
+    page->length = 0;
+    page->version = catalogVersion;
+    
+    if (page->view == LISTING_AVAILABLE) {
+        int* ids = (int*)malloc((availableBooks + 1) * sizeof(int));
+        if (!ids) {
+            printf("Memory allocation failed!\n");
+            return;
+        }
+        
+        int count = firstAvailableBooks(ids, availableBooks);
+        for (int i = 0; i < count; i++) {
+            Book* book = searchBook(ids[i]);
+            if (book) {
+                appendListing(page, "%-5d %-40s %-30s\n", book->id, bookTitle(book), bookAuthor(book));
+                page->rows++;
+            }
+        }
+        
+        free(ids);
+        return;
+    }
+    
+    while (temp) {
+        appendListing(page, "%-5d %-40s %-30s %-10s\n", 
+                      temp->id, bookTitle(temp), bookAuthor(temp), 
+                      temp->isBorrowed ? "Borrowed" : "Available");
+        page->rows++;
+        temp = temp->next;
+    }
+}
+
+void evictListing(ListingPage* page) {
+    listingCacheBytes -= page->capacity;
+    free(page->text);
+    memset(page, 0, sizeof(ListingPage));
+}
+
+int printListing(int view) {
+    ListingPage* slot = NULL;
+    int i;
+    
+    for (i = 0; i < LISTING_CACHE_SLOTS; i++) {
+        ListingPage* page = &listingCache[i];
+        if (page->text && page->view == view && page->version == catalogVersion) {
+            listingCacheHits++;
+            page->lastUsed = ++listingCacheClock;
+            fwrite(page->text, 1, page->length, stdout);
+            return page->rows;
+        }
+    }
+    listingCacheMisses++;
+    
+    ListingPage rendered;
+    memset(&rendered, 0, sizeof(rendered));
+    rendered.view = view;
+    renderListing(&rendered);
+    if (rendered.text)
+        fwrite(rendered.text, 1, rendered.length, stdout);
+    
+    for (i = 0; i < LISTING_CACHE_SLOTS; i++) {
+        if (listingCache[i].text && listingCache[i].version != catalogVersion)
+            evictListing(&listingCache[i]);
+    }
+    
+    while (rendered.text && rendered.capacity <= LISTING_CACHE_BUDGET) {
+        ListingPage* oldest = NULL;
+        slot = NULL;
+        for (i = 0; i < LISTING_CACHE_SLOTS; i++) {
+            if (!listingCache[i].text) {
+                if (!slot)
+                    slot = &listingCache[i];
+            } else if (!oldest || listingCache[i].lastUsed < oldest->lastUsed) {
+                oldest = &listingCache[i];
+            }
+        }
+        
+        if (slot && listingCacheBytes + rendered.capacity <= LISTING_CACHE_BUDGET) {
+            rendered.lastUsed = ++listingCacheClock;
+            *slot = rendered;
+            listingCacheBytes += rendered.capacity;
+            return rendered.rows;
+        }
+        evictListing(oldest);
+    }
+    
+    free(rendered.text);
+    return rendered.rows;
+}
+
+void clearListingCache() {
+    for (int i = 0; i < LISTING_CACHE_SLOTS; i++) {
+        if (listingCache[i].text)
+            evictListing(&listingCache[i]);
+    }
+}
+
+void displayMainMenu() {
+    clearScreen();
+    
+    printf("Login successful! Welcome, %s.\n\n", loggedInUsername);
+    printf("===== Library Management System =====\n");
+    printf("Logged in as: %s (%s)\n", loggedInName, loggedInUserType);
+    printf("Branch: %s\n", branchName);
+    
+    if (strcmp(loggedInUserType, "Faculty") == 0) {
+        printf("\n--- Admin Functions ---\n");
+        printf("1. Add New Book\n");
+        printf("2. Edit Book\n");
+        printf("3. Delete Book\n");
+        printf("11. Circulation Reports\n");
+        printf("14. Backup Library Data\n");
+        printf("15. Restore Library Data\n");
+    }
+    
+    printf("\n--- Book Functions ---\n");
+    printf("4. View All Books\n");
+    printf("5. Borrow a Book\n");
+    printf("6. Return a Book\n");
+    printf("7. View My Borrowed Books\n");
+    printf("12. View All Branches' Books\n");
+    printf("13. Search Books by Title/Author\n");
+    
+    printf("\n--- Account Functions ---\n");
+    printf("8. View My Account\n");
+    printf("9. Logout\n");
+    printf("10. Exit\n");
+    
+    printf("Enter your choice: ");
+}
+
+void addBook(int id, char* title, char* author) {
+    Book* newBook = (Book*)malloc(sizeof(Book));
+    if (!newBook) {
+        printf("Memory allocation failed!\n");
+        return;
+    }
+    
+    newBook->id = id;
+    newBook->titleHandle = storeTitle(title);
+    newBook->authorHandle = internAuthor(author);
+    newBook->isBorrowed = 0;
+    newBook->next = head;
+    head = newBook;
+    trackBook(newBook);
+    catalogVersion++;
+    
+    clearScreen();
+    displayMainMenu();
+    printf("\nBook added successfully!\n");
+    
+    checkpointLibraryData();
+}
+
+void displayBooks() {
+    clearScreen();
+    displayMainMenu();
+    
+    if (!head) {
+        printf("\nNo books in the library.\n");
+        return;
+    }
+    
+    printf("\nLibrary Books:\n");
+    printf("%-5s %-40s %-30s %-10s\n", "ID", "Title", "Author", "Status");
+    printf("------------------------------------------------------------------\n");
+    
+    printListing(LISTING_ALL);
+}
+
+Book* searchBook(int id) {
+    if (!bookBuckets)
+        return NULL;
+    
+    Book* temp = bookBuckets[bookSlot(id)];
+    while (temp) {
+        if (temp->id == id)
+            return temp;
+        temp = temp->hashNext;
+    }
+    return NULL;
+}
+
+void deleteBook(int id) {
+    Book *temp = head, *prev = NULL;
+    
+    while (temp && temp->id != id) {
+        prev = temp;
+        temp = temp->next;
+    }
+    
+    clearScreen();
+    displayMainMenu();
+    
+    if (!temp) {
+        printf("\nBook not found!\n");
+        return;
+    }
+    
+    if (temp->isBorrowed) {
+        printf("\nCannot delete a book that is currently borrowed!\n");
+        return;
+    }
+    
+    if (prev)
+        prev->next = temp->next;
+    else
+        head = temp->next;
+    untrackBook(temp);
+    releaseTitle(temp->titleHandle);
+    free(temp);
+    catalogVersion++;
+    compactTitlePool();
+    printf("\nBook deleted successfully!\n");
+    
+    checkpointLibraryData();
+}
+
+void editBook(int id) {
+    Book* book = searchBook(id);
+    
+    clearScreen();
+    displayMainMenu();
+    
+    if (!book) {
+        printf("\nBook not found!\n");
+        return;
+    }
+    
+    if (book->isBorrowed) {
+        printf("\nCannot edit a book that is currently borrowed!\n");
+        return;
+    }
+    
+    char title[100], author[100];
+    
+    printf("\nEnter new title (current: %s): ", bookTitle(book));
+    getchar();
+    fgets(title, sizeof(title), stdin);
+    title[strcspn(title, "\n")] = 0;
+    
+    printf("Enter new author (current: %s): ", bookAuthor(book));
+    fgets(author, sizeof(author), stdin);
+    author[strcspn(author, "\n")] = 0;
+    
+    unsigned int authorHandle = internAuthor(author);
+    int titleChanged = strcmp(title, bookTitle(book)) != 0;
+    if (titleChanged || authorHandle != book->authorHandle) {
+        untrackBook(book);
+        if (titleChanged) {
+            releaseTitle(book->titleHandle);
+            book->titleHandle = storeTitle(title);
+            compactTitlePool();
+        }
+        book->authorHandle = authorHandle;
+        trackBook(book);
+    }
+    catalogVersion++;
+    
+    printf("\nBook details updated successfully!\n");
+    
+    checkpointLibraryData();
+}
+
+unsigned int bigramSlot(unsigned char a, unsigned char b) {
+    return ((unsigned int)tolower(a) * 31u + (unsigned int)tolower(b)) & (SEARCH_BIGRAMS - 1);
+}
+
+void appendPosting(PostingList* list, unsigned int slot) {
+    if (list->count == list->capacity) {
+        int newCapacity = list->capacity ? list->capacity * 2 : 4;
+        unsigned int* newSlots = (unsigned int*)realloc(list->slots, newCapacity * sizeof(unsigned int));
+        if (!newSlots) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        list->slots = newSlots;
+        list->capacity = newCapacity;
+    }
+    list->slots[list->count++] = slot;
+}
+
+void indexBookText(Book* book) {
+    static unsigned int seen[SEARCH_BIGRAMS];
+    static unsigned int stamp = 0;
+    
+    if (searchBookCount == searchBookCapacity) {
+        unsigned int newCapacity = searchBookCapacity ? searchBookCapacity * 2 : 1024;
+        Book** newBooks = (Book**)realloc(searchBooks, newCapacity * sizeof(Book*));
+        unsigned char* newCounts = (unsigned char*)realloc(searchCounts, newCapacity);
+        if (newBooks)
+            searchBooks = newBooks;
+        if (newCounts)
+            searchCounts = newCounts;
+        if (!newBooks || !newCounts) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        memset(searchCounts + searchBookCapacity, 0, newCapacity - searchBookCapacity);
+        searchBookCapacity = newCapacity;
+    }
+    
+    unsigned int slot = searchBookCount++;
+    searchBooks[slot] = book;
+    book->searchSlot = slot;
+    
+    if (++stamp == 0) {
+        memset(seen, 0, sizeof(seen));
+        stamp = 1;
+    }
+    
+    const char* fields[2] = { bookTitle(book), bookAuthor(book) };
+    for (int f = 0; f < 2; f++) {
+        const char* text = fields[f];
+        for (int i = 0; text[i] && text[i + 1]; i++) {
+            unsigned int bigram = bigramSlot(text[i], text[i + 1]);
+            if (seen[bigram] != stamp) {
+                seen[bigram] = stamp;
+                appendPosting(&searchPostings[bigram], slot);
+            }
+        }
+    }
+}
+
+void rebuildSearchIndex() {
+    unsigned int oldCount = searchBookCount;
+    
+    for (int i = 0; i < SEARCH_BIGRAMS; i++)
+        searchPostings[i].count = 0;
+    searchBookCount = 0;
+    searchDeadCount = 0;
+    
+    for (unsigned int i = 0; i < oldCount; i++) {
+        if (searchBooks[i])
+            indexBookText(searchBooks[i]);
+    }
+}
+
+void unindexBookText(Book* book) {
+    searchBooks[book->searchSlot] = NULL;
+    searchDeadCount++;
+    
+    if (searchDeadCount >= SEARCH_REBUILD_MIN && searchDeadCount * 2 > searchBookCount)
+        rebuildSearchIndex();
+}
+
+void clearSearchIndex() {
+    for (int i = 0; i < SEARCH_BIGRAMS; i++)
+        searchPostings[i].count = 0;
+    searchBookCount = 0;
+    searchDeadCount = 0;
+}
+
+void buildSearchPattern(SearchPattern* pattern, const char* query) {
+    memset(pattern, 0, sizeof(SearchPattern));
+    
+    int length = strlen(query);
+    if (length > SEARCH_MAX_PATTERN)
+        length = SEARCH_MAX_PATTERN;
+    
+    for (int i = 0; i < length; i++)
+        pattern->peq[(unsigned char)tolower((unsigned char)query[i])] |= 1ULL << i;
+    
+    for (int i = 0; i + 1 < length; i++) {
+        unsigned int slot = bigramSlot(query[i], query[i + 1]);
+        if (!pattern->bigrams[slot]) {
+            pattern->bigrams[slot] = 1;
+            pattern->distinctBigrams++;
+        }
+    }
+    
+    pattern->length = length;
+    pattern->maxErrors = length / 3;
+}
+
+int sharesEnoughBigrams(const SearchPattern* pattern, const char* text) {
+    static unsigned int seen[SEARCH_BIGRAMS];
+    static unsigned int stamp = 0;
+    
+    int needed = pattern->distinctBigrams - 2 * pattern->maxErrors;
+    if (needed <= 0)
+        return 1;
+    
+    if (++stamp == 0) {
+        memset(seen, 0, sizeof(seen));
+        stamp = 1;
+    }
+    
+    int shared = 0;
+    for (int i = 0; text[i] && text[i + 1]; i++) {
+        unsigned int slot = bigramSlot(text[i], text[i + 1]);
+        if (pattern->bigrams[slot] && seen[slot] != stamp) {
+            seen[slot] = stamp;
+            if (++shared >= needed)
+                return 1;
+        }
+    }
+    return 0;
+}
+
+int substringDistance(const SearchPattern* pattern, const char* text) {
+    unsigned long long pv = ~0ULL, mv = 0;
+    unsigned long long high = 1ULL << (pattern->length - 1);
+    int score = pattern->length;
+    int best = score;
+    
+    for (int i = 0; text[i]; i++) {
+        unsigned long long eq = pattern->peq[(unsigned char)tolower((unsigned char)text[i])];
+        unsigned long long xv = eq | mv;
+        unsigned long long xh = (((eq & pv) + pv) ^ pv) | eq;
+        unsigned long long ph = mv | ~(xh | pv);
+        unsigned long long mh = pv & xh;
+        
+        if (ph & high)
+            score++;
+        else if (mh & high)
+            score--;
+        
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        
+        if (score < best)
+            best = score;
+    }
+    return best;
+}
+
+int matchDistance(const SearchPattern* pattern, const char* text) {
+    if (!sharesEnoughBigrams(pattern, text))
+        return pattern->maxErrors + 1;
+    return substringDistance(pattern, text);
+}
+
+void considerMatch(const SearchPattern* pattern, Book* book, SearchMatch* matches, int* found) {
+    int distance = matchDistance(pattern, bookTitle(book));
+    int authorDistance = matchDistance(pattern, bookAuthor(book));
+    if (authorDistance < distance)
+        distance = authorDistance;
+    
+    if (distance <= pattern->maxErrors && 
+        (*found < SEARCH_TOP_K || distance < matches[*found - 1].distance)) {
+        int i = *found < SEARCH_TOP_K ? (*found)++ : *found - 1;
+        while (i > 0 && matches[i - 1].distance > distance) {
+            matches[i] = matches[i - 1];
+            i--;
+        }
+        matches[i].book = book;
+        matches[i].distance = distance;
+    }
+}
+
+int compareCandidates(const void* a, const void* b) {
+    unsigned long long x = *(const unsigned long long*)a, y = *(const unsigned long long*)b;
+    return (x < y) - (x > y);
+}
+
+int findBooksByText(const char* query, SearchMatch* matches) {
+    SearchPattern pattern;
+    buildSearchPattern(&pattern, query);
+    
+    int found = 0;
+    if (pattern.length == 0)
+        return found;
+    
+    int needed = pattern.distinctBigrams - 2 * pattern.maxErrors;
+    int complete = needed > 0;
+    if (needed <= 0)
+        needed = 1;
+    
+    unsigned int* reached = NULL;
+    int reachedCount = 0, reachedCapacity = 0;
+    
+    for (int b = 0; b < SEARCH_BIGRAMS; b++) {
+        if (!pattern.bigrams[b])
+            continue;
+        PostingList* list = &searchPostings[b];
+        for (int i = 0; i < list->count; i++) {
+            unsigned int slot = list->slots[i];
+            if (++searchCounts[slot] != needed)
+                continue;
+            if (reachedCount == reachedCapacity) {
+                int newCapacity = reachedCapacity ? reachedCapacity * 2 : 256;
+                unsigned int* newReached = (unsigned int*)realloc(reached, newCapacity * sizeof(unsigned int));
+                if (!newReached)
+                    continue;
+                reached = newReached;
+                reachedCapacity = newCapacity;
+            }
+            reached[reachedCount++] = slot;
+        }
+    }
+    
+    unsigned long long* candidates = (unsigned long long*)malloc((reachedCount ? reachedCount : 1) * sizeof(unsigned long long));
+    int candidateCount = 0;
+    for (int i = 0; candidates && i < reachedCount; i++) {
+        unsigned int slot = reached[i];
+        if (searchBooks[slot])
+            candidates[candidateCount++] = ((unsigned long long)searchCounts[slot] << 32) | (0xFFFFFFFFu - slot);
+    }
+    
+    for (int b = 0; b < SEARCH_BIGRAMS; b++) {
+        if (!pattern.bigrams[b])
+            continue;
+        PostingList* list = &searchPostings[b];
+        for (int i = 0; i < list->count; i++)
+            searchCounts[list->slots[i]] = 0;
+    }
+    free(reached);
+    
+    if (candidates) {
+        qsort(candidates, candidateCount, sizeof(unsigned long long), compareCandidates);
+        for (int i = 0; i < candidateCount; i++) {
+            int shared = (int)(candidates[i] >> 32);
+            if (found == SEARCH_TOP_K && 
+                shared < pattern.distinctBigrams - 2 * (matches[found - 1].distance - 1))
+                break;
+            
+            unsigned int slot = 0xFFFFFFFFu - (unsigned int)(candidates[i] & 0xFFFFFFFFu);
+            considerMatch(&pattern, searchBooks[slot], matches, &found);
+        }
+        free(candidates);
+    }
+    
+    if (!complete && (found < SEARCH_TOP_K || 
+                      pattern.distinctBigrams - 2 * (matches[found - 1].distance - 1) <= 0)) {
+        found = 0;
+        Book* temp = head;
+        while (temp) {
+            considerMatch(&pattern, temp, matches, &found);
+            temp = temp->next;
+        }
+    }
+    return found;
+}
+
+void searchBooksByText() {
+    char query[100];
+    
+    clearScreen();
+    displayMainMenu();
+    
+    printf("\nEnter title or author to search: ");
+    fgets(query, sizeof(query), stdin);
+    query[strcspn(query, "\n")] = 0;
+    
+    clearScreen();
+    displayMainMenu();
+    
+    if (query[0] == 0) {
+        printf("\nPlease enter something to search for.\n");
+        return;
+    }
+    
+    NetworkMatch matches[SEARCH_TOP_K];
+    int found = findBooksAcrossBranches(query, matches);
+    
+    if (found == 0) {
+        printf("\nNo books in any branch match '%s'.\n", query);
+        return;
+    }
+    
+    printf("\nSearch Results for '%s' Across All Branches:\n", query);
+    printf("%-12s %-5s %-40s %-30s %-10s\n", "Branch", "ID", "Title", "Author", "Status");
+    printf("-------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < found; i++) {
+        BookFileRecord* book = &matches[i].book;
+        printf("%-12s %-5d %-40s %-30s %-10s\n", matches[i].branch, 
+               book->id, book->title, book->author, 
+               book->isBorrowed ? "Borrowed" : "Available");
+    }
+}
+
+User* findUserById(int id) {
+    User* temp = userHead;
+    while (temp) {
+        if (temp->id == id)
+            return temp;
+        temp = temp->next;
+    }
+    return NULL;
+}
+
+User* findUserByCredentials(const char* username, const char* password) {
+    User* temp = userHead;
+    while (temp) {
+        if (strcmp(temp->username, username) == 0 && strcmp(temp->password, password) == 0)
+            return temp;
+        temp = temp->next;
+    }
+    return NULL;
+}
+
+TokenBucket* findTokenBucket(TokenBucket* table, const char* key, long long now, int create) {
+    unsigned int hash = hashString(key) | 1;
+    TokenBucket* victim = NULL;
+    
+    for (unsigned int probe = 0; probe < THROTTLE_PROBES; probe++) {
+        TokenBucket* bucket = &table[(hash + probe) & (THROTTLE_SLOTS - 1)];
+        if (bucket->hash == hash && strcmp(bucket->key, key) == 0)
+            return bucket;
+        if (!victim || bucket->hash == 0 || 
+            (victim->hash != 0 && bucket->updatedAt < victim->updatedAt))
+            victim = bucket;
+    }
+    
+    if (!create)
+        return NULL;
+    
+    victim->hash = hash;
+    strncpy(victim->key, key, sizeof(victim->key) - 1);
+    victim->key[sizeof(victim->key) - 1] = 0;
+    victim->tokens = LOGIN_BURST;
+    victim->updatedAt = now;
+    return victim;
+}
+
+void refillTokenBucket(TokenBucket* bucket, long long now) {
+    long long earned = (now - bucket->updatedAt) / LOGIN_REFILL_SECONDS;
+    if (earned <= 0)
+        return;
+    
+    if (bucket->tokens + earned >= LOGIN_BURST) {
+        bucket->tokens = LOGIN_BURST;
+        bucket->updatedAt = now;
+    } else {
+        bucket->tokens += (int)earned;
+        bucket->updatedAt += earned * LOGIN_REFILL_SECONDS;
+    }
+}
+
+int bucketRetryAfter(TokenBucket* table, const char* key, long long now) {
+    TokenBucket* bucket = findTokenBucket(table, key, now, 0);
+    if (!bucket)
+        return 0;
+    
+    refillTokenBucket(bucket, now);
+    if (bucket->tokens > 0)
+        return 0;
+    return (int)(bucket->updatedAt + LOGIN_REFILL_SECONDS - now);
+}
+
+int loginRetryAfter(const char* username, const char* clientKey) {
+    long long now = (long long)time(NULL);
+    int userWait = bucketRetryAfter(usernameBuckets, username, now);
+    int clientWait = bucketRetryAfter(clientBuckets, clientKey, now);
+    return userWait > clientWait ? userWait : clientWait;
+}
+
+void recordLoginFailure(const char* username, const char* clientKey) {
+    long long now = (long long)time(NULL);
+    TokenBucket* buckets[2] = {
+        findTokenBucket(usernameBuckets, username, now, 1),
+        findTokenBucket(clientBuckets, clientKey, now, 1)
+    };
+    
+    for (int i = 0; i < 2; i++) {
+        refillTokenBucket(buckets[i], now);
+        if (buckets[i]->tokens == LOGIN_BURST)
+            buckets[i]->updatedAt = now;
+        if (buckets[i]->tokens > 0)
+            buckets[i]->tokens--;
+    }
+}
+
+User* getLoggedInUser() {
+    return findUserById(loggedInUserId);
+}
+
+int loginUser() {
+    char username[50], password[50];
+    
+    clearScreen();
+    printf("===== Library Management System =====\n");
+    printf("\n===== User Login =====\n");
+    printf("Enter Username: ");
+    fgets(username, sizeof(username), stdin);
+    username[strcspn(username, "\n")] = 0;
+    
+    printf("Enter Password: ");
+    fgets(password, sizeof(password), stdin);
+    password[strcspn(password, "\n")] = 0;
+    
+    int retryAfter = loginRetryAfter(username, "console");
+    if (retryAfter > 0) {
+        printf("\nToo many failed login attempts. Try again in %d seconds.\n", retryAfter);
+        printf("Press Enter to continue...");
+        getchar();
+        return 0;
+    }
+    
+    User* user = findUserByCredentials(username, password);
+    if (user) {
+        loggedInUserId = user->id;
+        strcpy(loggedInUserType, user->type);
+        strcpy(loggedInUsername, user->username);
+        strcpy(loggedInName, user->name);
+        
+        displayMainMenu();
+        return 1;
+    }
+    
+    recordLoginFailure(username, "console");
+    printf("\nInvalid username or password. Please try again.\n");
+    printf("Press Enter to continue...");
+    getchar();
+    return 0;
+}
+
+void logoutUser() {
+    if (loggedInUserId == -1) {
+        printf("\nNo user is currently logged in.\n");
+        return;
+    }
+    
+    loggedInUserId = -1;
+    strcpy(loggedInUserType, "");
+    strcpy(loggedInUsername, "");
     strcpy(loggedInName, "");
     
-    clearScreen();
-    printf("\nLogout successful. Thank you for using the Library System!\n");
-    sleep(1);
+    clearScreen();
+    printf("\nLogout successful. Thank you for using the Library System!\n");
+    sleep(1);
+}
+
+int applyBorrow(User* user, Book* book, const char* dueDate) {
+    BorrowRecord* newRecord = (BorrowRecord*)malloc(sizeof(BorrowRecord));
+    if (!newRecord) {
+        return 0;
+    }
+    
+    setBookBorrowed(book, 1);
+    
+    user->currentlyBorrowed++;
+    UserTypeStat* stat = userTypeStat(user->type);
+    if (stat)
+        stat->borrowed++;
+    
+    newRecord->bookId = book->id;
+    newRecord->userId = user->id;
+    strncpy(newRecord->dueDate, dueDate, sizeof(newRecord->dueDate) - 1);
+    newRecord->dueDate[sizeof(newRecord->dueDate) - 1] = 0;
+    newRecord->next = recordHead;
+    recordHead = newRecord;
+    return 1;
+}
+
+int borrowBookForUser(User* user, Book* book, const char* dueDate) {
+    if (!applyBorrow(user, book, dueDate))
+        return 0;
+    
+    recordLoanEvent(LOAN_BORROW, book->id, user->id, (long long)time(NULL));
+    journalLoanChange(LOAN_BORROW, book->id, user->id, dueDate);
+    return 1;
+}
+
+void borrowBookWithUser() {
+    clearScreen();
+    displayMainMenu();
+    
+    if (loggedInUserId == -1) {
+        printf("\nError: No user logged in.\n");
+        return;
+    }
+    
+    User* user = getLoggedInUser();
+    if (!user) {
+        printf("\nError: User account not found.\n");
+        return;
+    }
+    
+    if (user->currentlyBorrowed >= user->borrowLimit) {
+        printf("\nYou have reached your borrowing limit (%d books).\n", user->borrowLimit);
+        return;
+    }
+    
+    printf("\nAvailable Books:\n");
+    printf("%-5s %-40s %-30s\n", "ID", "Title", "Author");
+    printf("-------------------------------------------------------\n");
+    
+    if (availableBooks == 0) {
+        printf("\nNo books available for borrowing.\n");
+        return;
+    }
+    
+    printListing(LISTING_AVAILABLE);
+    
+    int bookId;
+    printf("\nEnter Book ID to borrow: ");
+    scanf("%d", &bookId);
+    getchar();
+    
+    Book* book = searchBook(bookId);
+    if (!book) {
+        printf("\nBook not found!\n");
+        return;
+    }
+    
+    if (book->isBorrowed) {
+        printf("\nThis book is already borrowed.\n");
+        return;
+    }
+    
+    char dueDate[20];
+    printf("Enter Due Date (DD/MM/YYYY): ");
+    fgets(dueDate, sizeof(dueDate), stdin);
+    dueDate[strcspn(dueDate, "\n")] = 0;
+    
+    if (!borrowBookForUser(user, book, dueDate)) {
+        printf("\nMemory allocation failed!\n");
+        return;
+    }
+    
+    clearScreen();
+    displayMainMenu();
+    printf("\nBook '%s' borrowed successfully!\n", bookTitle(book));
+    printf("Due date: %s\n", dueDate);
+    printf("You now have %d/%d books borrowed.\n", user->currentlyBorrowed, user->borrowLimit);
+}
+
+int applyReturn(int userId, Book* book) {
+    BorrowRecord *record = recordHead, *prev = NULL;
+    
+    while (record && !(record->bookId == book->id && record->userId == userId)) {
+        prev = record;
+        record = record->next;
+    }
+    
+    if (!record) {
+        return 0;
+    }
+    
+    setBookBorrowed(book, 0);
+    
+    User* user = findUserById(userId);
+    if (user) {
+        user->currentlyBorrowed--;
+        UserTypeStat* stat = userTypeStat(user->type);
+        if (stat)
+            stat->borrowed--;
+    }
+    
+    if (prev) {
+        prev->next = record->next;
+    } else {
+        recordHead = record->next;
+    }
+    free(record);
+    return 1;
+}
+
+int returnBookForUser(int userId, Book* book) {
+    if (!applyReturn(userId, book))
+        return 0;
+    
+    recordLoanEvent(LOAN_RETURN, book->id, userId, findLoanStart(book->id, userId));
+    journalLoanChange(LOAN_RETURN, book->id, userId, "");
+    return 1;
+}
+
+void returnBookWithUser() {
+    clearScreen();
+    displayMainMenu();
+    
+    if (loggedInUserId == -1) {
+        printf("\nError: No user logged in.\n");
+        return;
+    }
+    
+    printf("\nBooks you have borrowed:\n");
+    printf("%-5s %-40s %-30s %-15s\n", "ID", "Title", "Author", "Due Date");
+    printf("--------------------------------------------------------------------------\n");
+    
+    BorrowRecord* record = recordHead;
+    Book* book;
+    int borrowedCount = 0;
+    
+    while (record) {
+        if (record->userId == loggedInUserId) {
+            book = searchBook(record->bookId);
+            if (book) {
+                printf("%-5d %-40s %-30s %-15s\n", 
+                       book->id, bookTitle(book), bookAuthor(book), record->dueDate);
+                borrowedCount++;
+            }
+        }
+        record = record->next;
+    }
+    
+    if (borrowedCount == 0) {
+        printf("\nYou haven't borrowed any books.\n");
+        return;
+    }
+    
+    int bookId;
+    printf("\nEnter Book ID to return: ");
+    scanf("%d", &bookId);
+    getchar();
+    
+    book = searchBook(bookId);
+    if (!book) {
+        printf("\nBook not found!\n");
+        return;
+    }
+    
+    if (!returnBookForUser(loggedInUserId, book)) {
+        printf("\nYou haven't borrowed this book.\n");
+        return;
+    }
+    
+    User* user = getLoggedInUser();
+    
+    clearScreen();
+    displayMainMenu();
+    printf("\nBook '%s' returned successfully!\n", bookTitle(book));
+    if (user) {
+        printf("You now have %d/%d books borrowed.\n", user->currentlyBorrowed, user->borrowLimit);
+    }
+}
+
+void viewMyBorrowedBooks() {
+    clearScreen();
+    displayMainMenu();
+    
+    if (loggedInUserId == -1) {
+        printf("\nError: No user logged in.\n");
+        return;
+    }
+    
+    User* user = getLoggedInUser();
+    if (!user) {
+        printf("\nError: User account not found.\n");
+        return;
+    }
+    
+    printf("\n===== Your Borrowed Books =====\n");
+    printf("User: %s (%s)\n", user->name, user->type);
+    printf("Borrowing Status: %d/%d books\n\n", user->currentlyBorrowed, user->borrowLimit);
+    
+    printf("%-5s %-40s %-30s %-15s\n", "ID", "Title", "Author", "Due Date");
+    printf("--------------------------------------------------------------------------\n");
+    
+    BorrowRecord* record = recordHead;
+    Book* book;
+    int found = 0;
+    
+    while (record) {
+        if (record->userId == loggedInUserId) {
+            book = searchBook(record->bookId);
+            if (book) {
+                printf("%-5d %-40s %-30s %-15s\n", 
+                       book->id, bookTitle(book), bookAuthor(book), record->dueDate);
+                found = 1;
+            }
+        }
+        record = record->next;
+    }
+    
+    if (!found) {
+        printf("\nYou haven't borrowed any books yet.\n");
+    }
+}
+
+void viewMyAccount() {
+    clearScreen();
+    displayMainMenu();
+    
+    if (loggedInUserId == -1) {
+        printf("\nError: No user logged in.\n");
+        return;
+    }
+    
+    User* user = getLoggedInUser();
+    if (!user) {
+        printf("\nError: User account not found.\n");
+        return;
+    }
+    
+    printf("\n===== Your Account Details =====\n");
+    printf("User ID: %d\n", user->id);
+    printf("Username: %s\n", user->username);
+    printf("Name: %s\n", user->name);
+    printf("User Type: %s\n", user->type);
+    printf("Borrowing Limit: %d books\n", user->borrowLimit);
+    printf("Currently Borrowed: %d books\n", user->currentlyBorrowed);
+}
+
+int growLoanHistory() {
+    int newCapacity = history.capacity ? history.capacity * 2 : 1024;
+    int* bookIds = (int*)realloc(history.bookIds, newCapacity * sizeof(int));
+    if (bookIds) history.bookIds = bookIds;
+    int* userIds = (int*)realloc(history.userIds, newCapacity * sizeof(int));
+    if (userIds) history.userIds = userIds;
+    int* types = (int*)realloc(history.types, newCapacity * sizeof(int));
+    if (types) history.types = types;
+    long long* times = (long long*)realloc(history.times, newCapacity * sizeof(long long));
+    if (times) history.times = times;
+    long long* loanStarts = (long long*)realloc(history.loanStarts, newCapacity * sizeof(long long));
+    if (loanStarts) history.loanStarts = loanStarts;
+    
+    if (!bookIds || !userIds || !types || !times || !loanStarts) {
+        printf("Memory allocation failed!\n");
+        return 0;
+    }
+    
+    history.capacity = newCapacity;
+    return 1;
+}
+
+unsigned int openLoanHash(int bookId, int userId) {
+    unsigned int hash = (unsigned int)bookId * 2654435761u ^ (unsigned int)userId * 2246822519u;
+    return hash ^ (hash >> 15);
+}
+
+OpenLoan* findOpenLoan(int bookId, int userId, int forInsert) {
+    if (!openLoanCapacity)
+        return NULL;
+    
+    OpenLoan* reusable = NULL;
+    unsigned int i = openLoanHash(bookId, userId) & (openLoanCapacity - 1);
+    while (openLoans[i].state != OPEN_LOAN_EMPTY) {
+        OpenLoan* loan = &openLoans[i];
+        if (loan->state == OPEN_LOAN_USED && loan->bookId == bookId && loan->userId == userId)
+            return loan;
+        if (loan->state == OPEN_LOAN_DELETED && !reusable)
+            reusable = loan;
+        i = (i + 1) & (openLoanCapacity - 1);
+    }
+    if (!forInsert)
+        return NULL;
+    return reusable ? reusable : &openLoans[i];
+}
+
+void resizeOpenLoans(unsigned int newCapacity) {
+    OpenLoan* oldLoans = openLoans;
+    unsigned int oldCapacity = openLoanCapacity;
+    
+    openLoans = (OpenLoan*)calloc(newCapacity, sizeof(OpenLoan));
+    if (!openLoans) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    openLoanCapacity = newCapacity;
+    openLoanDeleted = 0;
+    
+    for (unsigned int i = 0; i < oldCapacity; i++) {
+        if (oldLoans[i].state == OPEN_LOAN_USED)
+            *findOpenLoan(oldLoans[i].bookId, oldLoans[i].userId, 1) = oldLoans[i];
+    }
+    free(oldLoans);
+}
+
+void setOpenLoan(int bookId, int userId, long long start) {
+    if ((openLoanCount + openLoanDeleted + 1) * 2 > openLoanCapacity) {
+        unsigned int newCapacity = openLoanCapacity ? openLoanCapacity : 64;
+        while ((openLoanCount + 1) * 4 > newCapacity)
+            newCapacity *= 2;
+        resizeOpenLoans(newCapacity);
+    }
+    
+    OpenLoan* loan = findOpenLoan(bookId, userId, 1);
+    if (loan->state != OPEN_LOAN_USED) {
+        if (loan->state == OPEN_LOAN_DELETED)
+            openLoanDeleted--;
+        openLoanCount++;
+    }
+    loan->bookId = bookId;
+    loan->userId = userId;
+    loan->start = start;
+    loan->state = OPEN_LOAN_USED;
+}
+
+void clearOpenLoan(int bookId, int userId) {
+    OpenLoan* loan = findOpenLoan(bookId, userId, 0);
+    if (!loan)
+        return;
+    loan->state = OPEN_LOAN_DELETED;
+    openLoanCount--;
+    openLoanDeleted++;
+}
+
+void resetOpenLoans() {
+    if (openLoans)
+        memset(openLoans, 0, openLoanCapacity * sizeof(OpenLoan));
+    openLoanCount = 0;
+    openLoanDeleted = 0;
+}
+
+int appendLoanEvent(const LoanEventRecord* event) {
+    if (history.count == history.capacity && !growLoanHistory())
+        return 0;
+    
+    int row = history.count++;
+    if (row == 0) {
+        history.minBookId = history.maxBookId = event->bookId;
+        history.minUserId = history.maxUserId = event->userId;
+    } else {
+        if (event->bookId < history.minBookId) history.minBookId = event->bookId;
+        if (event->bookId > history.maxBookId) history.maxBookId = event->bookId;
+        if (event->userId < history.minUserId) history.minUserId = event->userId;
+        if (event->userId > history.maxUserId) history.maxUserId = event->userId;
+    }
+    history.bookIds[row] = event->bookId;
+    history.userIds[row] = event->userId;
+    history.types[row] = event->type;
+    history.times[row] = event->time;
+    history.loanStarts[row] = event->loanStart;
+    
+    if (event->type == LOAN_BORROW)
+        setOpenLoan(event->bookId, event->userId, event->time);
+    else
+        clearOpenLoan(event->bookId, event->userId);
+    return 1;
+}
+
+void recordLoanEvent(int type, int bookId, int userId, long long loanStart) {
+    LoanEventRecord event;
+    memset(&event, 0, sizeof(event));
+    event.bookId = bookId;
+    event.userId = userId;
+    event.type = type;
+    event.time = (long long)time(NULL);
+    event.loanStart = loanStart;
+    
+    appendLoanEvent(&event);
+    
+    FILE* file = fopen(HISTORY_FILE, "ab");
+    if (!file) {
+        printf("Error: Could not open loan history file for writing.\n");
+        return;
+    }
+    fwrite(&event, sizeof(LoanEventRecord), 1, file);
+    fclose(file);
+}
+
+long long findLoanStart(int bookId, int userId) {
+    OpenLoan* loan = findOpenLoan(bookId, userId, 0);
+    return loan ? loan->start : LOAN_START_UNKNOWN;
+}
+
+void loadLoanHistoryFromFile() {
+    FILE* file = fopen(HISTORY_FILE, "rb");
+    if (!file) {
+        return;
+    }
+    
+    history.count = 0;
+    resetOpenLoans();
+    
+    LoanEventRecord event;
+    while (fread(&event, sizeof(LoanEventRecord), 1, file)) {
+        if (!appendLoanEvent(&event))
+            break;
+    }
+    
+    fclose(file);
+}
+
+int parseDate(const char* text, long long* result) {
+    int day, month, year;
+    if (sscanf(text, "%d/%d/%d", &day, &month, &year) != 3)
+        return 0;
+    
+    struct tm date;
+    memset(&date, 0, sizeof(date));
+    date.tm_mday = day;
+    date.tm_mon = month - 1;
+    date.tm_year = year - 1900;
+    date.tm_isdst = -1;
+    
+    time_t value = mktime(&date);
+    if (value == (time_t)-1)
+        return 0;
+    *result = (long long)value;
+    return 1;
+}
+
+int compareIdCountDesc(const void* a, const void* b) {
+    const IdCount* x = (const IdCount*)a;
+    const IdCount* y = (const IdCount*)b;
+    if (x->count != y->count)
+        return y->count - x->count;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+int compareUsersById(const void* a, const void* b) {
+    int x = (*(User* const*)a)->id, y = (*(User* const*)b)->id;
+    return (x > y) - (x < y);
+}
+
+int growIdCounter(IdCounter* counter) {
+    unsigned int newCapacity = counter->capacity ? counter->capacity * 2 : 1024;
+    IdCount* newSlots = (IdCount*)calloc(newCapacity, sizeof(IdCount));
+    if (!newSlots)
+        return 0;
+    
+    for (unsigned int i = 0; i < counter->capacity; i++) {
+        IdCount* entry = &counter->slots[i];
+        if (entry->count == 0)
+            continue;
+        unsigned int slot = ((unsigned int)entry->id * 2654435761u) & (newCapacity - 1);
+        while (newSlots[slot].count)
+            slot = (slot + 1) & (newCapacity - 1);
+        newSlots[slot] = *entry;
+    }
+    
+    free(counter->slots);
+    counter->slots = newSlots;
+    counter->capacity = newCapacity;
+    return 1;
+}
+
+int initIdCounter(IdCounter* counter, int minId, int maxId) {
+    memset(counter, 0, sizeof(IdCounter));
+    
+    unsigned int span = (unsigned int)maxId - (unsigned int)minId + 1;
+    if (span == 0 || span > REPORT_DENSE_LIMIT)
+        return 1;
+    
+    counter->dense = (int*)calloc(span, sizeof(int));
+    if (!counter->dense)
+        return 1;
+    counter->base = minId;
+    counter->span = span;
+    return 1;
+}
+
+int countId(IdCounter* counter, int id, int amount) {
+    if (counter->dense) {
+        counter->dense[(unsigned int)id - (unsigned int)counter->base] += amount;
+        return 1;
+    }
+    
+    if ((unsigned int)(counter->distinct + 1) * 2 > counter->capacity && !growIdCounter(counter))
+        return 0;
+    
+    unsigned int slot = ((unsigned int)id * 2654435761u) & (counter->capacity - 1);
+    while (counter->slots[slot].count && counter->slots[slot].id != id)
+        slot = (slot + 1) & (counter->capacity - 1);
+    
+    if (counter->slots[slot].count == 0) {
+        counter->slots[slot].id = id;
+        counter->distinct++;
+    }
+    counter->slots[slot].count += amount;
+    return 1;
+}
+
+int mergeIdCounter(IdCounter* target, const IdCounter* source) {
+    if (target->dense && source->dense) {
+        for (unsigned int i = 0; i < source->span; i++)
+            target->dense[i] += source->dense[i];
+        return 1;
+    }
+    
+    for (unsigned int i = 0; i < source->capacity; i++) {
+        if (source->slots[i].count && !countId(target, source->slots[i].id, source->slots[i].count))
+            return 0;
+    }
+    return 1;
+}
+
+void freeIdCounter(IdCounter* counter) {
+    free(counter->slots);
+    free(counter->dense);
+    memset(counter, 0, sizeof(IdCounter));
+}
+
+IdCount* compactIdCounter(IdCounter* counter, int* distinct) {
+    *distinct = 0;
+    
+    if (counter->dense) {
+        int used = 0;
+        for (unsigned int i = 0; i < counter->span; i++) {
+            if (counter->dense[i])
+                used++;
+        }
+        IdCount* counts = (IdCount*)malloc((used + 1) * sizeof(IdCount));
+        if (!counts)
+            return NULL;
+        for (unsigned int i = 0; i < counter->span; i++) {
+            if (counter->dense[i]) {
+                counts[*distinct].id = (int)((unsigned int)counter->base + i);
+                counts[*distinct].count = counter->dense[i];
+                (*distinct)++;
+            }
+        }
+        return counts;
+    }
+    
+    IdCount* counts = counter->slots;
+    counter->slots = NULL;
+    for (unsigned int i = 0; i < counter->capacity; i++) {
+        if (counts[i].count)
+            counts[(*distinct)++] = counts[i];
+    }
+    return counts;
+}
+
+void* scanHistoryRange(void* argument) {
+    ReportScan* scan = (ReportScan*)argument;
+    
+    scan->ok = initIdCounter(&scan->books, history.minBookId, history.maxBookId) && 
+               initIdCounter(&scan->users, history.minUserId, history.maxUserId);
+    
+    for (int row = scan->firstRow; scan->ok && row < scan->lastRow; row++) {
+        long long when = history.times[row];
+        if ((scan->hasFrom && when < scan->from) || (scan->hasTo && when > scan->to))
+            continue;
+        
+        if (history.types[row] == LOAN_BORROW) {
+            scan->ok = countId(&scan->books, history.bookIds[row], 1) && 
+                       countId(&scan->users, history.userIds[row], 1);
+            scan->loans++;
+        } else {
+            if (history.loanStarts[row] != LOAN_START_UNKNOWN) {
+                scan->totalDuration += when - history.loanStarts[row];
+                scan->timedReturns++;
+            }
+            scan->returns++;
+        }
+    }
+    return NULL;
+}
+
+int reportThreadCount() {
+    int threads = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (threads > history.count / REPORT_ROWS_PER_THREAD)
+        threads = history.count / REPORT_ROWS_PER_THREAD;
+    if (threads > REPORT_MAX_THREADS)
+        threads = REPORT_MAX_THREADS;
+    return threads < 1 ? 1 : threads;
+}
+
+void showCirculationReports() {
+    char input[20];
+    long long from = 0, to = 0;
+    
+    printf("\nEnter start date (DD/MM/YYYY, blank for all): ");
+    fgets(input, sizeof(input), stdin);
+    input[strcspn(input, "\n")] = 0;
+    int hasFrom = parseDate(input, &from);
+    
+    printf("Enter end date (DD/MM/YYYY, blank for all): ");
+    fgets(input, sizeof(input), stdin);
+    input[strcspn(input, "\n")] = 0;
+    int hasTo = parseDate(input, &to);
+    if (hasTo)
+        to += 24 * 60 * 60 - 1;
+    
+    clearScreen();
+    displayMainMenu();
+    
+    ReportScan scans[REPORT_MAX_THREADS];
+    pthread_t threads[REPORT_MAX_THREADS];
+    int started[REPORT_MAX_THREADS];
+    int threadCount = reportThreadCount();
+    
+    for (int t = 0; t < threadCount; t++) {
+        memset(&scans[t], 0, sizeof(ReportScan));
+        scans[t].firstRow = (int)((long long)history.count * t / threadCount);
+        scans[t].lastRow = (int)((long long)history.count * (t + 1) / threadCount);
+        scans[t].hasFrom = hasFrom;
+        scans[t].hasTo = hasTo;
+        scans[t].from = from;
+        scans[t].to = to;
+        started[t] = t > 0 && pthread_create(&threads[t], NULL, scanHistoryRange, &scans[t]) == 0;
+    }
+    for (int t = 0; t < threadCount; t++) {
+        if (started[t])
+            pthread_join(threads[t], NULL);
+        else
+            scanHistoryRange(&scans[t]);
+    }
+    
+    ReportScan* total = &scans[0];
+    for (int t = 1; t < threadCount; t++) {
+        if (total->ok)
+            total->ok = scans[t].ok && mergeIdCounter(&total->books, &scans[t].books) && 
+                        mergeIdCounter(&total->users, &scans[t].users);
+        total->loans += scans[t].loans;
+        total->returns += scans[t].returns;
+        total->timedReturns += scans[t].timedReturns;
+        total->totalDuration += scans[t].totalDuration;
+        freeIdCounter(&scans[t].books);
+        freeIdCounter(&scans[t].users);
+    }
+    
+    int distinctBooks = 0, distinctUsers = 0;
+    IdCount* bookCounts = total->ok ? compactIdCounter(&total->books, &distinctBooks) : NULL;
+    IdCount* userCounts = total->ok ? compactIdCounter(&total->users, &distinctUsers) : NULL;
+    freeIdCounter(&total->books);
+    freeIdCounter(&total->users);
+    if (!bookCounts || !userCounts) {
+        printf("\nMemory allocation failed!\n");
+        free(bookCounts);
+        free(userCounts);
+        return;
+    }
+    
+    int loans = total->loans, returns = total->returns, timedReturns = total->timedReturns;
+    long long totalDuration = total->totalDuration;
+    
+    printf("\n===== Circulation Reports =====\n");
+    printf("Loans: %d   Returns: %d\n", loans, returns);
+    if (listingCacheHits + listingCacheMisses > 0) {
+        printf("Listing cache: %lu/%lu hits (%.1f%%), %lu bytes\n", 
+               listingCacheHits, listingCacheHits + listingCacheMisses,
+               100.0 * listingCacheHits / (listingCacheHits + listingCacheMisses),
+               (unsigned long)listingCacheBytes);
+    }
+    if (timedReturns > 0) {
+        printf("Average loan duration: %.1f days", 
+               (double)totalDuration / timedReturns / (24.0 * 60 * 60));
+        if (timedReturns < returns)
+            printf(" (%d returns with unknown start excluded)", returns - timedReturns);
+        printf("\n");
+    }
+    
+    printf("\nCatalog: %d books, %d available, %d borrowed\n", 
+           totalBooks, availableBooks, borrowedBooks);
+    for (int i = 0; i < userTypeCount; i++) {
+        printf("  %-10s %d users, %d books borrowed\n", userTypeStats[i].type, 
+               userTypeStats[i].users, userTypeStats[i].borrowed);
+    }
+    
+    int* authorLoans = (int*)calloc(authorCount + 1, sizeof(int));
+    if (authorLoans) {
+        for (int i = 0; i < distinctBooks; i++) {
+            Book* book = searchBook(bookCounts[i].id);
+            if (book)
+                authorLoans[book->authorHandle] += bookCounts[i].count;
+        }
+    }
+    
+    qsort(bookCounts, distinctBooks, sizeof(IdCount), compareIdCountDesc);
+    qsort(userCounts, distinctUsers, sizeof(IdCount), compareIdCountDesc);
+    
+    printf("\nTop %d Titles:\n", REPORT_TOP_N);
+    printf("%-5s %-40s %-10s\n", "ID", "Title", "Loans");
+    printf("-------------------------------------------------------\n");
+    for (int i = 0; i < distinctBooks && i < REPORT_TOP_N; i++) {
+        Book* book = searchBook(bookCounts[i].id);
+        printf("%-5d %-40s %-10d\n", bookCounts[i].id, 
+               book ? bookTitle(book) : "(deleted)", bookCounts[i].count);
+    }
+    
+    int userTotal = 0;
+    for (User* user = userHead; user; user = user->next)
+        userTotal++;
+    User** usersById = (User**)malloc((userTotal + 1) * sizeof(User*));
+    if (usersById) {
+        userTotal = 0;
+        for (User* user = userHead; user; user = user->next)
+            usersById[userTotal++] = user;
+        qsort(usersById, userTotal, sizeof(User*), compareUsersById);
+    }
+    
+    printf("\nCirculation by User:\n");
+    printf("%-5s %-30s %-10s\n", "ID", "Name", "Loans");
+    printf("-------------------------------------------------------\n");
+    for (int i = 0; i < distinctUsers; i++) {
+        User* user = NULL;
+        int low = 0, high = usersById ? userTotal : 0;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (usersById[mid]->id < userCounts[i].id)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if (low < userTotal && usersById && usersById[low]->id == userCounts[i].id)
+            user = usersById[low];
+        printf("%-5d %-30s %-10d\n", userCounts[i].id, 
+               user ? user->name : "(removed)", userCounts[i].count);
+    }
+    
+    if (authorLoans) {
+        printf("\nUtilization by Author:\n");
+        printf("%-30s %-10s %-10s %-10s %-10s\n", "Author", "Books", "Available", "Loans", "Per Book");
+        printf("-------------------------------------------------------------------------\n");
+        for (unsigned int i = 0; i < authorCount; i++) {
+            AuthorEntry* author = &authorTable[i];
+            if (author->bookCount == 0 && authorLoans[i] == 0)
+                continue;
+            printf("%-30s %-10d %-10d %-10d %-10.2f\n", author->name, author->bookCount, 
+                   author->availableCount, authorLoans[i],
+                   author->bookCount ? (double)authorLoans[i] / author->bookCount : 0.0);
+        }
+    }
+    
+    free(authorLoans);
+    free(usersById);
+    free(bookCounts);
+    free(userCounts);
+}
+
+FILE* beginFileReplace(const char* path, char* tempPath, size_t size) {
+    snprintf(tempPath, size, "%s.tmp", path);
+    return fopen(tempPath, "wb");
+}
+
+int commitFileReplace(FILE* file, const char* tempPath, const char* path) {
+    int ok = !ferror(file);
+    if (fclose(file) != 0)
+        ok = 0;
+    
+    if (ok) {
+#ifdef _WIN32
+        remove(path);
+#endif
+        ok = rename(tempPath, path) == 0;
+    }
+    if (!ok)
+        remove(tempPath);
+    return ok;
+}
+
+int saveUsersToFile() {
+    char tempPath[MAX_PATH_LENGTH + 8];
+    FILE* file = beginFileReplace(USER_FILE, tempPath, sizeof(tempPath));
+    if (!file) {
+        printf("Error: Could not open users file for writing.\n");
+        return 0;
+    }
+    
+    User* temp = userHead;
+    while (temp) {
+        fwrite(temp, sizeof(User), 1, file);
+        temp = temp->next;
+    }
+    
+    if (!commitFileReplace(file, tempPath, USER_FILE)) {
+        printf("Error: Could not save users file.\n");
+        return 0;
+    }
+    return 1;
+}
+
+int saveBooksToFile() {
+    char tempPath[MAX_PATH_LENGTH + 8];
+    FILE* file = beginFileReplace(BOOK_FILE, tempPath, sizeof(tempPath));
+    if (!file) {
+        printf("Error: Could not open books file for writing.\n");
+        return 0;
+    }
+    
+    BookFileRecord bookData;
+    Book* temp = head;
+    while (temp) {
+        memset(&bookData, 0, sizeof(bookData));
+        bookData.id = temp->id;
+        strncpy(bookData.title, bookTitle(temp), sizeof(bookData.title) - 1);
+        strncpy(bookData.author, bookAuthor(temp), sizeof(bookData.author) - 1);
+        bookData.isBorrowed = temp->isBorrowed;
+        fwrite(&bookData, sizeof(BookFileRecord), 1, file);
+        temp = temp->next;
+    }
+    
+    if (!commitFileReplace(file, tempPath, BOOK_FILE)) {
+        printf("Error: Could not save books file.\n");
+        return 0;
+    }
+    return 1;
+}
+
+int checkpointLibraryData() {
+    int ok = saveUsersToFile();
+    ok = saveBooksToFile() && ok;
+    ok = saveBorrowRecordsToFile() && ok;
+    if (!ok)
+        return 0;
+    
+    FILE* file = fopen(JOURNAL_FILE, "wb");
+    if (!file) {
+        printf("Error: Could not clear loan journal.\n");
+        return 0;
+    }
+    fclose(file);
+    journalEntries = 0;
+    return 1;
+}
+
+void journalLoanChange(int type, int bookId, int userId, const char* dueDate) {
+    JournalRecord entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.type = type;
+    entry.bookId = bookId;
+    entry.userId = userId;
+    strncpy(entry.dueDate, dueDate, sizeof(entry.dueDate) - 1);
+    
+    FILE* file = fopen(JOURNAL_FILE, "ab");
+    int ok = file && fwrite(&entry, sizeof(JournalRecord), 1, file) == 1;
+    if (file && fclose(file) != 0)
+        ok = 0;
+    
+    if (!ok || ++journalEntries >= JOURNAL_CHECKPOINT_ENTRIES)
+        checkpointLibraryData();
+}
+
+void replayLoanJournal() {
+    FILE* file = fopen(JOURNAL_FILE, "rb");
+    if (!file) {
+        journalEntries = 0;
+        return;
+    }
+    
+    JournalRecord entry;
+    int replayed = 0;
+    while (fread(&entry, sizeof(JournalRecord), 1, file)) {
+        entry.dueDate[sizeof(entry.dueDate) - 1] = 0;
+        Book* book = searchBook(entry.bookId);
+        if (!book)
+            continue;
+        
+        BorrowRecord* record = recordHead;
+        while (record && record->bookId != entry.bookId)
+            record = record->next;
+        
+        if (entry.type == LOAN_BORROW && !record) {
+            User* user = findUserById(entry.userId);
+            if (user)
+                applyBorrow(user, book, entry.dueDate);
+        } else if (entry.type == LOAN_RETURN && record && record->userId == entry.userId) {
+            applyReturn(entry.userId, book);
+        } else if (entry.type == LOAN_RETURN && !record) {
+            setBookBorrowed(book, 0);
+        }
+        replayed++;
+    }
+    fclose(file);
+    
+    journalEntries = replayed;
+    if (replayed)
+        checkpointLibraryData();
+}
+
+int saveBorrowRecordsToFile() {
+    char tempPath[MAX_PATH_LENGTH + 8];
+    FILE* file = beginFileReplace(BORROW_FILE, tempPath, sizeof(tempPath));
+    if (!file) {
+        printf("Error: Could not open borrow records file for writing.\n");
+        return 0;
+    }
+    
+    BorrowRecord* temp = recordHead;
+    while (temp) {
+        fwrite(temp, sizeof(BorrowRecord), 1, file);
+        temp = temp->next;
+    }
+    
+    if (!commitFileReplace(file, tempPath, BORROW_FILE)) {
+        printf("Error: Could not save borrow records file.\n");
+        return 0;
+    }
+    return 1;
+}
+
+void loadUsersFromFile() {
+    FILE* file = fopen(USER_FILE, "rb");
+    if (!file) {
+        User* defaultUser = (User*)malloc(sizeof(User));
+        if (defaultUser) {
+            defaultUser->id = 1;
+            strcpy(defaultUser->username, "abcd");
+            strcpy(defaultUser->password, "1234");
+            strcpy(defaultUser->name, "ABCD");
+            strcpy(defaultUser->type, "Faculty");
+            defaultUser->borrowLimit = 5;
+            defaultUser->currentlyBorrowed = 0;
+            defaultUser->next = NULL;
+            userHead = defaultUser;
+            saveUsersToFile();
+        }
+        return;
+    }
+    
+    User *temp = userHead, *next;
+    while (temp) {
+        next = temp->next;
+        free(temp);
+        temp = next;
+    }
+    userHead = NULL;
+    
+    User userData;
+    User* lastNode = NULL;
+    
+    while (fread(&userData, sizeof(User), 1, file)) {
+        User* newUser = (User*)malloc(sizeof(User));
+        if (!newUser) {
+            printf("Memory allocation failed!\n");
+            continue;
+        }
+        
+        *newUser = userData;
+        newUser->next = NULL;
+        
+        if (lastNode) {
+            lastNode->next = newUser;
+            lastNode = newUser;
+        } else {
+            userHead = newUser;
+            lastNode = newUser;
+        }
+    }
+    
+    fclose(file);
+}
+
+void loadBooksFromFile() {
+    FILE* file = fopen(BOOK_FILE, "rb");
+    if (!file) {
+        return;
+    }
+    
+    Book *temp = head, *next;
+    while (temp) {
+        next = temp->next;
+        free(temp);
+        temp = next;
+    }
+    head = NULL;
+    resetCatalogIndexes();
+    titlePoolUsed = 0;
+    titlePoolWasted = 0;
+    catalogVersion++;
+    
+    BookFileRecord bookData;
+    Book* lastNode = NULL;
+    
+    while (fread(&bookData, sizeof(BookFileRecord), 1, file)) {
+        Book* newBook = (Book*)malloc(sizeof(Book));
+        if (!newBook) {
+            printf("Memory allocation failed!\n");
+            continue;
+        }
+        
+        bookData.title[sizeof(bookData.title) - 1] = 0;
+        bookData.author[sizeof(bookData.author) - 1] = 0;
+        newBook->id = bookData.id;
+        newBook->titleHandle = storeTitle(bookData.title);
+        newBook->authorHandle = internAuthor(bookData.author);
+        newBook->isBorrowed = bookData.isBorrowed ? 1 : 0;
+        newBook->next = NULL;
+        trackBook(newBook);
+        
+        if (lastNode) {
+            lastNode->next = newBook;
+            lastNode = newBook;
+        } else {
+            head = newBook;
+            lastNode = newBook;
+        }
+    }
+    
+    fclose(file);
+}
+
+void loadBorrowRecordsFromFile() {
+    FILE* file = fopen(BORROW_FILE, "rb");
+    if (!file) {
+        return;
+    }
+    
+    BorrowRecord *temp = recordHead, *next;
+    while (temp) {
+        next = temp->next;
+        free(temp);
+        temp = next;
+    }
+    recordHead = NULL;
+    
+    BorrowRecord recordData;
+    BorrowRecord* lastNode = NULL;
+    
+    while (fread(&recordData, sizeof(BorrowRecord), 1, file)) {
+        BorrowRecord* newRecord = (BorrowRecord*)malloc(sizeof(BorrowRecord));
+        if (!newRecord) {
+            printf("Memory allocation failed!\n");
+            continue;
+        }
+        
+        *newRecord = recordData;
+        newRecord->next = NULL;
+        
+        if (lastNode) {
+            lastNode->next = newRecord;
+            lastNode = newRecord;
+        } else {
+            recordHead = newRecord;
+            lastNode = newRecord;
+        }
+    }
+    
+    fclose(file);
+}
+
+unsigned int crc32Table[256];
+
+unsigned int computeCrc32(const unsigned char* data, size_t length) {
+    if (crc32Table[1] == 0) {
+        for (unsigned int i = 0; i < 256; i++) {
+            unsigned int value = i;
+            for (int bit = 0; bit < 8; bit++)
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            crc32Table[i] = value;
+        }
+    }
+    
+    unsigned int crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++)
+        crc = crc32Table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
 }
 
-void borrowBookWithUser() {
-    clearScreen();
-    displayMainMenu();
+int appendBytes(ByteBuffer* buffer, const void* data, size_t length) {
+    if (buffer->length + length > buffer->capacity) {
+        size_t newCapacity = buffer->capacity ? buffer->capacity : 4096;
+        while (buffer->length + length > newCapacity)
+            newCapacity *= 2;
+        unsigned char* newData = (unsigned char*)realloc(buffer->data, newCapacity);
+        if (!newData) {
+            printf("Memory allocation failed!\n");
+            return 0;
+        }
+        buffer->data = newData;
+        buffer->capacity = newCapacity;
+    }
     
-    if (loggedInUserId == -1) {
-        printf("\nError: No user logged in.\n");
-        return;
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    return 1;
+}
+
+size_t packBlock(const unsigned char* input, size_t length, unsigned char* output) {
+    size_t in = 0, out = 0;
+    
+    while (in < length) {
+        size_t run = 1;
+        while (in + run < length && run < 128 && input[in + run] == input[in])
+            run++;
+        
+        if (run >= 3) {
+            output[out++] = (unsigned char)(257 - run);
+            output[out++] = input[in];
+            in += run;
+            continue;
+        }
+        
+        size_t start = in, literals = 0;
+        while (in < length && literals < 128) {
+            if (in + 2 < length && input[in] == input[in + 1] && input[in] == input[in + 2])
+                break;
+            in++;
+            literals++;
+        }
+        output[out++] = (unsigned char)(literals - 1);
+        memcpy(output + out, input + start, literals);
+        out += literals;
+    }
+    return out;
+}
+
+size_t unpackBlock(const unsigned char* input, size_t length, unsigned char* output, size_t capacity) {
+    size_t in = 0, out = 0;
+    
+    while (in < length) {
+        unsigned char control = input[in++];
+        if (control < 128) {
+            size_t literals = (size_t)control + 1;
+            if (in + literals > length || out + literals > capacity)
+                return (size_t)-1;
+            memcpy(output + out, input + in, literals);
+            in += literals;
+            out += literals;
+        } else {
+            size_t run = 257 - (size_t)control;
+            if (in >= length || control == 128 || out + run > capacity)
+                return (size_t)-1;
+            memset(output + out, input[in++], run);
+            out += run;
+        }
+    }
+    return out;
+}
+
+int writeBackupSection(FILE* file, unsigned int section, const ByteBuffer* raw) {
+    unsigned char packed[BACKUP_BLOCK_SIZE + BACKUP_BLOCK_SIZE / 128 + 16];
+    unsigned long long totalLength = raw->length;
+    
+    if (fwrite(&section, sizeof(section), 1, file) != 1 || 
+        fwrite(&totalLength, sizeof(totalLength), 1, file) != 1)
+        return 0;
+    
+    for (size_t offset = 0; offset < raw->length; offset += BACKUP_BLOCK_SIZE) {
+        BackupBlockHeader block;
+        size_t length = raw->length - offset;
+        if (length > BACKUP_BLOCK_SIZE)
+            length = BACKUP_BLOCK_SIZE;
+        
+        block.rawLength = (unsigned int)length;
+        block.packedLength = (unsigned int)packBlock(raw->data + offset, length, packed);
+        block.checksum = computeCrc32(raw->data + offset, length);
+        
+        if (fwrite(&block, sizeof(block), 1, file) != 1 || 
+            fwrite(packed, 1, block.packedLength, file) != block.packedLength)
+            return 0;
+    }
+    return 1;
+}
+
+int readBackupSection(FILE* file, ByteBuffer* raw, unsigned long long totalLength) {
+    unsigned char packed[BACKUP_BLOCK_SIZE + BACKUP_BLOCK_SIZE / 128 + 16];
+    unsigned char block[BACKUP_BLOCK_SIZE];
+    
+    while (raw->length < totalLength) {
+        BackupBlockHeader header;
+        if (fread(&header, sizeof(header), 1, file) != 1 || 
+            header.rawLength == 0 || header.rawLength > BACKUP_BLOCK_SIZE || 
+            header.packedLength > sizeof(packed) || 
+            fread(packed, 1, header.packedLength, file) != header.packedLength)
+            return 0;
+        
+        size_t length = unpackBlock(packed, header.packedLength, block, sizeof(block));
+        if (length != header.rawLength || computeCrc32(block, length) != header.checksum)
+            return 0;
+        if (!appendBytes(raw, block, length))
+            return 0;
+    }
+    return raw->length == totalLength;
+}
+
+int snapshotLibrary(ByteBuffer sections[BACKUP_SECTIONS]) {
+    User* user = userHead;
+    while (user) {
+        if (!appendBytes(&sections[0], user, sizeof(User)))
+            return 0;
+        user = user->next;
     }
     
-    User* user = getLoggedInUser();
-    if (!user) {
-        printf("\nError: User account not found.\n");
-        return;
+    BookFileRecord bookData;
+    Book* book = head;
+    while (book) {
+        memset(&bookData, 0, sizeof(bookData));
+        bookData.id = book->id;
+        strncpy(bookData.title, bookTitle(book), sizeof(bookData.title) - 1);
+        strncpy(bookData.author, bookAuthor(book), sizeof(bookData.author) - 1);
+        bookData.isBorrowed = book->isBorrowed;
+        if (!appendBytes(&sections[1], &bookData, sizeof(bookData)))
+            return 0;
+        book = book->next;
     }
     
-    if (user->currentlyBorrowed >= user->borrowLimit) {
-        printf("\nYou have reached your borrowing limit (%d books).\n", user->borrowLimit);
-        return;
+    BorrowRecord* record = recordHead;
+    while (record) {
+        if (!appendBytes(&sections[2], record, sizeof(BorrowRecord)))
+            return 0;
+        record = record->next;
     }
     
-    printf("\nAvailable Books:\n");
-    printf("%-5s %-40s %-30s\n", "ID", "Title", "Author");
-    printf("-------------------------------------------------------\n");
+    LoanEventRecord event;
+    for (int row = 0; row < history.count; row++) {
+        memset(&event, 0, sizeof(event));
+        event.bookId = history.bookIds[row];
+        event.userId = history.userIds[row];
+        event.type = history.types[row];
+        event.time = history.times[row];
+        event.loanStart = history.loanStarts[row];
+        if (!appendBytes(&sections[3], &event, sizeof(event)))
+            return 0;
+    }
+    return 1;
+}
+
+int writeTempFile(const char* path, const ByteBuffer* data, char* tempPath, size_t size) {
+    FILE* file = beginFileReplace(path, tempPath, size);
+    if (!file)
+        return 0;
+    
+    size_t written = data->length ? fwrite(data->data, 1, data->length, file) : 0;
+    if (fclose(file) != 0 || written != data->length) {
+        remove(tempPath);
+        return 0;
+    }
+    return 1;
+}
+
+int replaceFilesTogether(const char* files[BACKUP_SECTIONS], const ByteBuffer sections[BACKUP_SECTIONS]) {
+    char tempPaths[BACKUP_SECTIONS][MAX_PATH_LENGTH + 8];
+    char oldPaths[BACKUP_SECTIONS][MAX_PATH_LENGTH + 8];
+    int hadOld[BACKUP_SECTIONS] = { 0, 0, 0, 0 };
+    int written = 0, swapped = 0;
+    
+    while (written < BACKUP_SECTIONS && 
+           writeTempFile(files[written], &sections[written], tempPaths[written], sizeof(tempPaths[written])))
+        written++;
+    
+    if (written < BACKUP_SECTIONS) {
+        for (int i = 0; i < written; i++)
+            remove(tempPaths[i]);
+        return 0;
+    }
     
-    Book* temp = head;
-    int availableCount = 0;
+    while (swapped < BACKUP_SECTIONS) {
+        const char* path = files[swapped];
+        FILE* existing = fopen(path, "rb");
+        if (existing)
+            fclose(existing);
+        
+        snprintf(oldPaths[swapped], sizeof(oldPaths[swapped]), "%s.old", path);
+        remove(oldPaths[swapped]);
+        if (existing) {
+            if (rename(path, oldPaths[swapped]) != 0)
+                break;
+            hadOld[swapped] = 1;
+        }
+        
+        if (rename(tempPaths[swapped], path) != 0) {
+            if (hadOld[swapped])
+                rename(oldPaths[swapped], path);
+            break;
+        }
+        swapped++;
+    }
     
-    while (temp) {
-        if (!temp->isBorrowed) {
-            printf("%-5d %-40s %-30s\n", temp->id, temp->title, temp->author);
-            availableCount++;
+    if (swapped < BACKUP_SECTIONS) {
+        for (int i = swapped; i < BACKUP_SECTIONS; i++)
+            remove(tempPaths[i]);
+        for (int i = swapped - 1; i >= 0; i--) {
+            remove(files[i]);
+            if (hadOld[i])
+                rename(oldPaths[i], files[i]);
         }
-        temp = temp->next;
+        return 0;
     }
     
-    if (availableCount == 0) {
-        printf("\nNo books available for borrowing.\n");
-        return;
+    for (int i = 0; i < BACKUP_SECTIONS; i++) {
+        if (hadOld[i])
+            remove(oldPaths[i]);
     }
+    return 1;
+}
+
+void readBackupFileName(char* path, size_t size) {
+    printf("\nEnter backup file name (blank for %s): ", DEFAULT_BACKUP_FILE);
+    fgets(path, size, stdin);
+    path[strcspn(path, "\n")] = 0;
+    if (path[0] == 0)
+        snprintf(path, size, "%s", DEFAULT_BACKUP_FILE);
+}
+
+void backupLibraryData() {
+    char path[MAX_PATH_LENGTH];
+    char tempPath[MAX_PATH_LENGTH + 8];
+    ByteBuffer sections[BACKUP_SECTIONS];
     
-    int bookId;
-    printf("\nEnter Book ID to borrow: ");
-    scanf("%d", &bookId);
-    getchar();
+    readBackupFileName(path, sizeof(path));
     
-    Book* book = searchBook(bookId);
-    if (!book) {
-        printf("\nBook not found!\n");
-        return;
-    }
+    clearScreen();
+    displayMainMenu();
     
-    if (book->isBorrowed) {
-        printf("\nThis book is already borrowed.\n");
+    memset(sections, 0, sizeof(sections));
+    if (!snapshotLibrary(sections)) {
+        for (int i = 0; i < BACKUP_SECTIONS; i++)
+            free(sections[i].data);
+        printf("\nError: Not enough memory to snapshot the library. No backup was written.\n");
         return;
     }
     
-    char dueDate[20];
-    printf("Enter Due Date (DD/MM/YYYY): ");
-    fgets(dueDate, sizeof(dueDate), stdin);
-    dueDate[strcspn(dueDate, "\n")] = 0;
-    
-    book->isBorrowed = 1;
+    FILE* file = beginFileReplace(path, tempPath, sizeof(tempPath));
+    int ok = file != NULL && fwrite(BACKUP_MAGIC, 1, sizeof(BACKUP_MAGIC), file) == sizeof(BACKUP_MAGIC);
+    for (unsigned int i = 0; ok && i < BACKUP_SECTIONS; i++)
+        ok = writeBackupSection(file, i + 1, &sections[i]);
+    if (file && ok) {
+        ok = commitFileReplace(file, tempPath, path);
+    } else if (file) {
+        fclose(file);
+        remove(tempPath);
+    }
     
-    user->currentlyBorrowed++;
+    size_t rawBytes = 0;
+    for (int i = 0; i < BACKUP_SECTIONS; i++) {
+        rawBytes += sections[i].length;
+        free(sections[i].data);
+    }
     
-    BorrowRecord* newRecord = (BorrowRecord*)malloc(sizeof(BorrowRecord));
-    if (!newRecord) {
-        printf("\nMemory allocation failed!\n");
+    if (!ok) {
+        printf("\nError: Could not write backup file '%s'. Any previous backup there is unchanged.\n", path);
         return;
     }
     
-    newRecord->bookId = bookId;
-    newRecord->userId = loggedInUserId;
-    strcpy(newRecord->dueDate, dueDate);
-    newRecord->next = recordHead;
-    recordHead = newRecord;
-    
-    saveUsersToFile();
-    saveBooksToFile();
-    saveBorrowRecordsToFile();
-    
-    clearScreen();
-    displayMainMenu();
-    printf("\nBook '%s' borrowed successfully!\n", book->title);
-    printf("Due date: %s\n", dueDate);
-    printf("You now have %d/%d books borrowed.\n", user->currentlyBorrowed, user->borrowLimit);
+    printf("\nBackup written to '%s' (%lu bytes of library data).\n", path, (unsigned long)rawBytes);
 }
 
-void returnBookWithUser() {
+void restoreLibraryData() {
+    char path[MAX_PATH_LENGTH];
+    char magic[sizeof(BACKUP_MAGIC)];
+    ByteBuffer sections[BACKUP_SECTIONS];
+    const size_t recordSizes[BACKUP_SECTIONS] = {
+        sizeof(User), sizeof(BookFileRecord), sizeof(BorrowRecord), sizeof(LoanEventRecord)
+    };
+    int seen[BACKUP_SECTIONS] = { 0, 0, 0, 0 };
+    
+    readBackupFileName(path, sizeof(path));
+    
     clearScreen();
     displayMainMenu();
     
-    if (loggedInUserId == -1) {
-        printf("\nError: No user logged in.\n");
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("\nError: Could not open backup file '%s'.\n", path);
         return;
     }
     
-    printf("\nBooks you have borrowed:\n");
-    printf("%-5s %-40s %-30s %-15s\n", "ID", "Title", "Author", "Due Date");
-    printf("--------------------------------------------------------------------------\n");
-    
-    BorrowRecord *record = recordHead, *prev = NULL, *toDelete = NULL;
-    Book* book;
-    int borrowedCount = 0;
-    
-    while (record) {
-        if (record->userId == loggedInUserId) {
-            book = searchBook(record->bookId);
-            if (book) {
-                printf("%-5d %-40s %-30s %-15s\n", 
-                       book->id, book->title, book->author, record->dueDate);
-                borrowedCount++;
-            }
-        }
-        record = record->next;
+    memset(sections, 0, sizeof(sections));
+    int ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && 
+             memcmp(magic, BACKUP_MAGIC, sizeof(magic)) == 0;
+    
+    unsigned int section;
+    unsigned long long totalLength;
+    while (ok && fread(&section, sizeof(section), 1, file) == 1) {
+        ok = section >= 1 && section <= BACKUP_SECTIONS && !seen[section - 1] && 
+             fread(&totalLength, sizeof(totalLength), 1, file) == 1 && 
+             totalLength % recordSizes[section - 1] == 0 && 
+             readBackupSection(file, &sections[section - 1], totalLength);
+        if (ok)
+            seen[section - 1] = 1;
     }
+    fclose(file);
     
-    if (borrowedCount == 0) {
-        printf("\nYou haven't borrowed any books.\n");
-        return;
+    for (int i = 0; i < BACKUP_SECTIONS; i++) {
+        if (!seen[i])
+            ok = 0;
     }
     
-    int bookId;
-    printf("\nEnter Book ID to return: ");
-    scanf("%d", &bookId);
-    getchar();
-    
-    book = searchBook(bookId);
-    if (!book) {
-        printf("\nBook not found!\n");
+    if (!ok) {
+        printf("\nError: '%s' is not a valid backup or failed its checksums. Nothing was restored.\n", path);
+        for (int i = 0; i < BACKUP_SECTIONS; i++)
+            free(sections[i].data);
         return;
     }
     
-    record = recordHead;
-    prev = NULL;
-    int foundRecord = 0;
-    
-    while (record) {
-        if (record->bookId == bookId && record->userId == loggedInUserId) {
-            foundRecord = 1;
-            toDelete = record;
-            break;
-        }
-        prev = record;
-        record = record->next;
-    }
+    const char* files[BACKUP_SECTIONS] = { USER_FILE, BOOK_FILE, BORROW_FILE, HISTORY_FILE };
+    ok = replaceFilesTogether(files, sections);
+    for (int i = 0; i < BACKUP_SECTIONS; i++)
+        free(sections[i].data);
     
-    if (!foundRecord) {
-        printf("\nYou haven't borrowed this book.\n");
+    if (!ok) {
+        printf("\nError: Could not write the restored data files. Nothing was restored.\n");
         return;
     }
+    remove(JOURNAL_FILE);
     
-    book->isBorrowed = 0;
+    initializeProgramData();
     
     User* user = getLoggedInUser();
-    if (user) {
-        user->currentlyBorrowed--;
-    }
-    
-    if (prev) {
-        prev->next = toDelete->next;
-    } else {
-        recordHead = toDelete->next;
+    if (!user) {
+        logoutUser();
+        printf("Your account is not in the restored data. Please log in again.\n");
+        return;
     }
-    free(toDelete);
-    
-    saveUsersToFile();
-    saveBooksToFile();
-    saveBorrowRecordsToFile();
     
     clearScreen();
     displayMainMenu();
-    printf("\nBook '%s' returned successfully!\n", book->title);
-    if (user) {
-        printf("You now have %d/%d books borrowed.\n", user->currentlyBorrowed, user->borrowLimit);
-    }
+    printf("\nLibrary data restored from '%s': %d books, %d borrowed.\n", path, totalBooks, borrowedBooks);
 }
 
-void viewMyBorrowedBooks() {
-    clearScreen();
-    displayMainMenu();
+void cleanupMemory() {
+    Book *bookTemp = head, *bookNext;
+    while (bookTemp) {
+        bookNext = bookTemp->next;
+        free(bookTemp);
+        bookTemp = bookNext;
+    }
     
-    if (loggedInUserId == -1) {
-        printf("\nError: No user logged in.\n");
-        return;
+    User *userTemp = userHead, *userNext;
+    while (userTemp) {
+        userNext = userTemp->next;
+        free(userTemp);
+        userTemp = userNext;
     }
     
-    User* user = getLoggedInUser();
-    if (!user) {
-        printf("\nError: User account not found.\n");
-        return;
+    BorrowRecord *recordTemp = recordHead, *recordNext;
+    while (recordTemp) {
+        recordNext = recordTemp->next;
+        free(recordTemp);
+        recordTemp = recordNext;
     }
     
-    printf("\n===== Your Borrowed Books =====\n");
-    printf("User: %s (%s)\n", user->name, user->type);
-    printf("Borrowing Status: %d/%d books\n\n", user->currentlyBorrowed, user->borrowLimit);
+    for (unsigned int i = 0; i < authorCount; i++)
+        free(authorTable[i].name);
+    free(authorTable);
+    free(authorBuckets);
+    free(titlePool);
+    clearListingCache();
+    
+    for (int i = 0; i < availableChunkCount; i++)
+        freeAvailableChunk(availableChunks[i]);
+    free(availableChunks);
+    free(bookBuckets);
+    
+    for (int i = 0; i < SEARCH_BIGRAMS; i++)
+        free(searchPostings[i].slots);
+    free(searchBooks);
+    free(searchCounts);
+    
+    free(history.bookIds);
+    free(history.userIds);
+    free(history.types);
+    free(history.times);
+    free(history.loanStarts);
+    free(openLoans);
+}
+
+int isValidBranchName(const char* name) {
+    size_t length = strlen(name);
+    if (length == 0 || length >= sizeof(branchName) || !isalnum((unsigned char)name[0]))
+        return 0;
+    for (size_t i = 1; i < length; i++) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '_' && name[i] != '-')
+            return 0;
+    }
+    return 1;
+}
+
+int buildBranchPath(char* path, size_t size, const char* branch, const char* file) {
+    int written;
+    if (strcmp(branch, DEFAULT_BRANCH) == 0)
+        written = snprintf(path, size, "%s", file);
+    else
+        written = snprintf(path, size, "%.31s_%s", branch, file);
+    return written >= 0 && (size_t)written < size;
+}
+
+int loadBranchList(char branches[][32]) {
+    int count = 0;
+    char line[64];
     
-    printf("%-5s %-40s %-30s %-15s\n", "ID", "Title", "Author", "Due Date");
-    printf("--------------------------------------------------------------------------\n");
+    strcpy(branches[count++], DEFAULT_BRANCH);
     
-    BorrowRecord* record = recordHead;
-    Book* book;
-    int found = 0;
+    FILE* file = fopen(BRANCH_FILE, "r");
+    if (!file) {
+        return count;
+    }
     
-    while (record) {
-        if (record->userId == loggedInUserId) {
-            book = searchBook(record->bookId);
-            if (book) {
-                printf("%-5d %-40s %-30s %-15s\n", 
-                       book->id, book->title, book->author, record->dueDate);
-                found = 1;
-            }
+    while (count < MAX_BRANCHES && fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (!isValidBranchName(line))
+            continue;
+        
+        int known = 0;
+        for (int i = 0; i < count; i++) {
+            if (strcmp(branches[i], line) == 0)
+                known = 1;
         }
-        record = record->next;
+        if (!known)
+            strcpy(branches[count++], line);
     }
     
-    if (!found) {
-        printf("\nYou haven't borrowed any books yet.\n");
-    }
+    fclose(file);
+    return count;
 }
 
-void viewMyAccount() {
-    clearScreen();
-    displayMainMenu();
-    
-    if (loggedInUserId == -1) {
-        printf("\nError: No user logged in.\n");
-        return;
+int selectBranch(const char* name) {
+    if (!isValidBranchName(name))
+        return 0;
+    
+    strcpy(branchName, name);
+    buildBranchPath(USER_FILE, sizeof(USER_FILE), name, "users.dat");
+    buildBranchPath(BOOK_FILE, sizeof(BOOK_FILE), name, "books.dat");
+    buildBranchPath(BORROW_FILE, sizeof(BORROW_FILE), name, "borrow_records.dat");
+    buildBranchPath(HISTORY_FILE, sizeof(HISTORY_FILE), name, "loan_history.dat");
+    buildBranchPath(JOURNAL_FILE, sizeof(JOURNAL_FILE), name, "loan_journal.dat");
+    
+    char branches[MAX_BRANCHES][32];
+    int count = loadBranchList(branches);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(branches[i], name) == 0)
+            return 1;
     }
     
-    User* user = getLoggedInUser();
-    if (!user) {
-        printf("\nError: User account not found.\n");
-        return;
+    FILE* file = fopen(BRANCH_FILE, "a");
+    if (file) {
+        fprintf(file, "%s\n", name);
+        fclose(file);
     }
-    
-    printf("\n===== Your Account Details =====\n");
-    printf("User ID: %d\n", user->id);
-    printf("Username: %s\n", user->username);
-    printf("Name: %s\n", user->name);
-    printf("User Type: %s\n", user->type);
-    printf("Borrowing Limit: %d books\n", user->borrowLimit);
-    printf("Currently Borrowed: %d books\n", user->currentlyBorrowed);
+    return 1;
 }
 
-void saveUsersToFile() {
-    FILE* file = fopen(USER_FILE, "wb");
-    if (!file) {
-        printf("Error: Could not open users file for writing.\n");
-        return;
+int readWholeFile(const char* path, ByteBuffer* buffer) {
+    unsigned char chunk[65536];
+    size_t length;
+    int ok = 1;
+    
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return 0;
+    while (ok && (length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        ok = appendBytes(buffer, chunk, length);
+    fclose(file);
+    return ok;
+}
+
+int compareRecordIds(const void* a, const void* b) {
+    int x = (*(BookFileRecord* const*)a)->id, y = (*(BookFileRecord* const*)b)->id;
+    return (x > y) - (x < y);
+}
+
+int loadBranchCatalog(const char* branch, BranchCatalog* catalog) {
+    char path[MAX_PATH_LENGTH];
+    ByteBuffer journal, books;
+    
+    memset(&journal, 0, sizeof(journal));
+    memset(&books, 0, sizeof(books));
+    memset(catalog, 0, sizeof(BranchCatalog));
+    
+    if (buildBranchPath(path, sizeof(path), branch, "loan_journal.dat"))
+        readWholeFile(path, &journal);
+    if (!buildBranchPath(path, sizeof(path), branch, "books.dat") || !readWholeFile(path, &books)) {
+        free(journal.data);
+        free(books.data);
+        return 0;
     }
     
-    User* temp = userHead;
-    while (temp) {
-        fwrite(temp, sizeof(User), 1, file);
-        temp = temp->next;
+    catalog->books = (BookFileRecord*)books.data;
+    catalog->count = books.length / sizeof(BookFileRecord);
+    for (int i = 0; i < catalog->count; i++) {
+        catalog->books[i].title[sizeof(catalog->books[i].title) - 1] = 0;
+        catalog->books[i].author[sizeof(catalog->books[i].author) - 1] = 0;
+    }
+    
+    int entries = journal.length / sizeof(JournalRecord);
+    BookFileRecord** byId = entries && catalog->count ? 
+        (BookFileRecord**)malloc(catalog->count * sizeof(BookFileRecord*)) : NULL;
+    if (byId) {
+        for (int i = 0; i < catalog->count; i++)
+            byId[i] = &catalog->books[i];
+        qsort(byId, catalog->count, sizeof(BookFileRecord*), compareRecordIds);
+        
+        for (int i = 0; i < entries; i++) {
+            const JournalRecord* entry = (const JournalRecord*)journal.data + i;
+            BookFileRecord key;
+            BookFileRecord* keyPointer = &key;
+            key.id = entry->bookId;
+            BookFileRecord** found = (BookFileRecord**)bsearch(&keyPointer, byId, catalog->count, 
+                                                               sizeof(BookFileRecord*), compareRecordIds);
+            if (found)
+                (*found)->isBorrowed = entry->type == LOAN_BORROW;
+        }
     }
     
-    fclose(file);
+    free(byId);
+    free(journal.data);
+    return 1;
 }
 
-void saveBooksToFile() {
-    FILE* file = fopen(BOOK_FILE, "wb");
-    if (!file) {
-        printf("Error: Could not open books file for writing.\n");
+void keepNetworkMatch(NetworkMatch* matches, int* found, const char* branch, 
+                      const BookFileRecord* book, int distance) {
+    if (*found == SEARCH_TOP_K && distance >= matches[*found - 1].distance)
         return;
+    
+    int i = *found < SEARCH_TOP_K ? (*found)++ : *found - 1;
+    while (i > 0 && matches[i - 1].distance > distance) {
+        matches[i] = matches[i - 1];
+        i--;
     }
+    strcpy(matches[i].branch, branch);
+    matches[i].book = *book;
+    matches[i].distance = distance;
+}
+
+int findBooksAcrossBranches(const char* query, NetworkMatch* matches) {
+    char branches[MAX_BRANCHES][32];
+    int count = loadBranchList(branches);
+    int found = 0;
     
-    Book* temp = head;
-    while (temp) {
-        fwrite(temp, sizeof(Book), 1, file);
-        temp = temp->next;
+    SearchPattern pattern;
+    buildSearchPattern(&pattern, query);
+    if (pattern.length == 0)
+        return found;
+    
+    SearchMatch local[SEARCH_TOP_K];
+    int localFound = findBooksByText(query, local);
+    BookFileRecord bookData;
+    for (int i = 0; i < localFound; i++) {
+        memset(&bookData, 0, sizeof(bookData));
+        bookData.id = local[i].book->id;
+        strncpy(bookData.title, bookTitle(local[i].book), sizeof(bookData.title) - 1);
+        strncpy(bookData.author, bookAuthor(local[i].book), sizeof(bookData.author) - 1);
+        bookData.isBorrowed = local[i].book->isBorrowed;
+        keepNetworkMatch(matches, &found, branchName, &bookData, local[i].distance);
     }
     
-    fclose(file);
+    for (int i = 0; i < count; i++) {
+        BranchCatalog catalog;
+        if (strcmp(branches[i], branchName) == 0 || !loadBranchCatalog(branches[i], &catalog))
+            continue;
+        
+        for (int j = 0; j < catalog.count; j++) {
+            BookFileRecord* book = &catalog.books[j];
+            int distance = matchDistance(&pattern, book->title);
+            int authorDistance = matchDistance(&pattern, book->author);
+            if (authorDistance < distance)
+                distance = authorDistance;
+            if (distance <= pattern.maxErrors)
+                keepNetworkMatch(matches, &found, branches[i], book, distance);
+        }
+        free(catalog.books);
+    }
+    return found;
 }
 
-void saveBorrowRecordsToFile() {
-    FILE* file = fopen(BORROW_FILE, "wb");
-    if (!file) {
-        printf("Error: Could not open borrow records file for writing.\n");
-        return;
+void displayNetworkCatalog() {
+    char branches[MAX_BRANCHES][32];
+    int count = loadBranchList(branches);
+    int total = 0;
+    
+    clearScreen();
+    displayMainMenu();
+    
+    printf("\nBooks Across All Branches:\n");
+    printf("%-12s %-5s %-40s %-30s %-10s\n", "Branch", "ID", "Title", "Author", "Status");
+    printf("-------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < count; i++) {
+        BranchCatalog catalog;
+        if (!loadBranchCatalog(branches[i], &catalog))
+            continue;
+        
+        for (int j = 0; j < catalog.count; j++) {
+            BookFileRecord* bookData = &catalog.books[j];
+            printf("%-12s %-5d %-40s %-30s %-10s\n", branches[i], bookData->id, 
+                   bookData->title, bookData->author, 
+                   bookData->isBorrowed ? "Borrowed" : "Available");
+            total++;
+        }
+        free(catalog.books);
     }
     
-    BorrowRecord* temp = recordHead;
-    while (temp) {
-        fwrite(temp, sizeof(BorrowRecord), 1, file);
-        temp = temp->next;
+    if (total == 0) {
+        printf("\nNo books in any branch.\n");
+    }
+}
+
+#ifdef __linux__
+volatile sig_atomic_t serverRunning = 1;
+ClientSession* delayedSessions = NULL;
+unsigned long connectionSerial = 0;
+
+long long monotonicMillis() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+void stopServer(int signalNumber) {
+    (void)signalNumber;
+    serverRunning = 0;
+}
+
+void appendBookRow(ClientSession* session, Book* book) {
+    appendListing(&session->output, "%d\t%s\t%s\t%s\n", book->id, bookTitle(book), 
+                  bookAuthor(book), book->isBorrowed ? "Borrowed" : "Available");
+}
+
+int sessionAcceptsInput(const ClientSession* session) {
+    return !session->resumeAt && !session->throttled && !session->pendingBooks && !session->closing;
+}
+
+void fillPendingRows(ClientSession* session) {
+    while (session->pendingNext < session->pendingCount && 
+           session->output.length < SERVER_OUTPUT_HIGH_WATER)
+        appendBookRow(session, session->pendingBooks[session->pendingNext++]);
+    
+    if (session->pendingNext == session->pendingCount) {
+        free(session->pendingBooks);
+        session->pendingBooks = NULL;
+        session->pendingCount = 0;
+        session->pendingNext = 0;
+    }
+}
+
+void startPendingRows(ClientSession* session, Book** books, int count) {
+    appendListing(&session->output, "OK %d\n", count);
+    session->pendingBooks = books;
+    session->pendingCount = count;
+    session->pendingNext = 0;
+    fillPendingRows(session);
+}
+
+void updateSessionEvents(int epollFd, ClientSession* session) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    if (sessionAcceptsInput(session))
+        event.events |= EPOLLIN;
+    if (session->output.length && !session->resumeAt)
+        event.events |= EPOLLOUT;
+    event.data.ptr = session;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, session->fd, &event);
+}
+
+void closeSession(int epollFd, ClientSession* session) {
+    if (session->resumeAt) {
+        ClientSession** link = &delayedSessions;
+        while (*link && *link != session)
+            link = &(*link)->nextDelayed;
+        if (*link)
+            *link = session->nextDelayed;
     }
     
-    fclose(file);
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, session->fd, NULL);
+    close(session->fd);
+    free(session->output.text);
+    free(session->pendingBooks);
+    free(session);
 }
 
-void loadUsersFromFile() {
-    FILE* file = fopen(USER_FILE, "rb");
-    if (!file) {
-        User* defaultUser = (User*)malloc(sizeof(User));
-        if (defaultUser) {
-            defaultUser->id = 1;
-            strcpy(defaultUser->username, "abcd");
-            strcpy(defaultUser->password, "1234");
-            strcpy(defaultUser->name, "ABCD");
-            strcpy(defaultUser->type, "Faculty");
-            defaultUser->borrowLimit = 5;
-            defaultUser->currentlyBorrowed = 0;
-            defaultUser->next = NULL;
-            userHead = defaultUser;
-            saveUsersToFile();
+int flushSession(ClientSession* session) {
+    if (session->resumeAt)
+        return 1;
+    
+    while (1) {
+        size_t sent = 0;
+        int blocked = 0;
+        
+        while (sent < session->output.length) {
+            ssize_t written = send(session->fd, session->output.text + sent, 
+                                   session->output.length - sent, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    blocked = 1;
+                    break;
+                }
+                if (errno == EINTR)
+                    continue;
+                return 0;
+            }
+            sent += written;
         }
-        return;
+        
+        memmove(session->output.text, session->output.text + sent, session->output.length - sent);
+        session->output.length -= sent;
+        
+        if (session->output.length >= SERVER_OUTPUT_LOW_WATER)
+            return 1;
+        session->throttled = 0;
+        if (blocked || !session->pendingBooks)
+            return 1;
+        fillPendingRows(session);
     }
+}
+
+int handleCommand(ClientSession* session, char* line) {
+    char* command = strtok(line, " ");
+    char* argument = strtok(NULL, "");
+    User* user = session->userId == -1 ? NULL : findUserById(session->userId);
     
-    User *temp = userHead, *next;
-    while (temp) {
-        next = temp->next;
-        free(temp);
-        temp = next;
+    if (!command) {
+        return 1;
     }
-    userHead = NULL;
     
-    User userData;
-    User* lastNode = NULL;
+    if (strcmp(command, "QUIT") == 0) {
+        appendListing(&session->output, "OK bye\n");
+        return 0;
+    }
     
-    while (fread(&userData, sizeof(User), 1, file)) {
-        User* newUser = (User*)malloc(sizeof(User));
-        if (!newUser) {
-            printf("Memory allocation failed!\n");
-            continue;
+    if (strcmp(command, "LOGIN") == 0) {
+        char* username = argument ? strtok(argument, " ") : NULL;
+        char* password = username ? strtok(NULL, "") : NULL;
+        
+        int retryAfter = loginRetryAfter(username ? username : "", session->clientKey);
+        if (retryAfter > 0) {
+            appendListing(&session->output, "ERR too many failed logins, retry in %d seconds\n", retryAfter);
+            return 1;
         }
         
-        *newUser = userData;
-        newUser->next = NULL;
+        User* found = password ? findUserByCredentials(username, password) : NULL;
+        if (!found) {
+            recordLoginFailure(username ? username : "", session->clientKey);
+            session->resumeAt = monotonicMillis() + LOGIN_FAILURE_DELAY_MS;
+            session->nextDelayed = delayedSessions;
+            delayedSessions = session;
+            appendListing(&session->output, "ERR invalid username or password\n");
+            return 1;
+        }
         
-        if (lastNode) {
-            lastNode->next = newUser;
-            lastNode = newUser;
+        session->userId = found->id;
+        appendListing(&session->output, "OK %s %s\n", found->name, found->type);
+        return 1;
+    }
+    
+    if (!user) {
+        appendListing(&session->output, "ERR login required\n");
+        return 1;
+    }
+    
+    if (strcmp(command, "LOGOUT") == 0) {
+        session->userId = -1;
+        appendListing(&session->output, "OK\n");
+    } else if (strcmp(command, "LIST") == 0) {
+        Book** books = (Book**)malloc((totalBooks + 1) * sizeof(Book*));
+        int count = 0;
+        for (Book* temp = head; books && temp; temp = temp->next)
+            books[count++] = temp;
+        
+        if (books)
+            startPendingRows(session, books, count);
+        else
+            appendListing(&session->output, "ERR memory allocation failed\n");
+    } else if (strcmp(command, "AVAILABLE") == 0) {
+        int* ids = (int*)malloc((availableBooks + 1) * sizeof(int));
+        Book** books = (Book**)malloc((availableBooks + 1) * sizeof(Book*));
+        int count = ids && books ? firstAvailableBooks(ids, availableBooks) : 0;
+        for (int i = 0; i < count; i++)
+            books[i] = searchBook(ids[i]);
+        free(ids);
+        
+        if (ids && books) {
+            startPendingRows(session, books, count);
         } else {
-            userHead = newUser;
-            lastNode = newUser;
+            free(books);
+            appendListing(&session->output, "ERR memory allocation failed\n");
         }
+    } else if (strcmp(command, "SEARCH") == 0) {
+        SearchMatch matches[SEARCH_TOP_K];
+        int found = argument ? findBooksByText(argument, matches) : 0;
+        appendListing(&session->output, "OK %d\n", found);
+        for (int i = 0; i < found; i++)
+            appendBookRow(session, matches[i].book);
+    } else if (strcmp(command, "SEARCHALL") == 0) {
+        NetworkMatch matches[SEARCH_TOP_K];
+        int found = argument ? findBooksAcrossBranches(argument, matches) : 0;
+        appendListing(&session->output, "OK %d\n", found);
+        for (int i = 0; i < found; i++)
+            appendListing(&session->output, "%s\t%d\t%s\t%s\t%s\n", matches[i].branch, 
+                          matches[i].book.id, matches[i].book.title, matches[i].book.author, 
+                          matches[i].book.isBorrowed ? "Borrowed" : "Available");
+    } else if (strcmp(command, "MINE") == 0) {
+        appendListing(&session->output, "OK %d\n", user->currentlyBorrowed);
+        BorrowRecord* record = recordHead;
+        while (record) {
+            Book* book = record->userId == user->id ? searchBook(record->bookId) : NULL;
+            if (book)
+                appendListing(&session->output, "%d\t%s\t%s\t%s\n", book->id, 
+                              bookTitle(book), bookAuthor(book), record->dueDate);
+            record = record->next;
+        }
+    } else if (strcmp(command, "BORROW") == 0) {
+        int bookId;
+        char dueDate[20];
+        Book* book = NULL;
+        
+        if (!argument || sscanf(argument, "%d %19s", &bookId, dueDate) != 2)
+            appendListing(&session->output, "ERR usage: BORROW <id> <DD/MM/YYYY>\n");
+        else if (user->currentlyBorrowed >= user->borrowLimit)
+            appendListing(&session->output, "ERR borrowing limit reached (%d books)\n", user->borrowLimit);
+        else if (!(book = searchBook(bookId)))
+            appendListing(&session->output, "ERR book not found\n");
+        else if (book->isBorrowed)
+            appendListing(&session->output, "ERR book already borrowed\n");
+        else if (!borrowBookForUser(user, book, dueDate))
+            appendListing(&session->output, "ERR memory allocation failed\n");
+        else
+            appendListing(&session->output, "OK %d/%d\n", user->currentlyBorrowed, user->borrowLimit);
+    } else if (strcmp(command, "RETURN") == 0) {
+        int bookId;
+        Book* book = NULL;
+        
+        if (!argument || sscanf(argument, "%d", &bookId) != 1)
+            appendListing(&session->output, "ERR usage: RETURN <id>\n");
+        else if (!(book = searchBook(bookId)))
+            appendListing(&session->output, "ERR book not found\n");
+        else if (!returnBookForUser(user->id, book))
+            appendListing(&session->output, "ERR book not borrowed by you\n");
+        else
+            appendListing(&session->output, "OK %d/%d\n", user->currentlyBorrowed, user->borrowLimit);
+    } else {
+        appendListing(&session->output, "ERR unknown command\n");
     }
-    
-    fclose(file);
+    return 1;
 }
 
-void loadBooksFromFile() {
-    FILE* file = fopen(BOOK_FILE, "rb");
-    if (!file) {
-        return;
-    }
+int processSessionInput(ClientSession* session) {
+    size_t start = 0;
     
-    Book *temp = head, *next;
-    while (temp) {
-        next = temp->next;
-        free(temp);
-        temp = next;
+    while (sessionAcceptsInput(session)) {
+        char* newline = (char*)memchr(session->input + start, '\n', session->inputLength - start);
+        if (!newline)
+            break;
+        
+        *newline = 0;
+        if (newline > session->input + start && newline[-1] == '\r')
+            newline[-1] = 0;
+        
+        int keepOpen = handleCommand(session, session->input + start);
+        start = newline - session->input + 1;
+        if (!keepOpen)
+            return 0;
+        if (session->output.length >= SERVER_OUTPUT_HIGH_WATER)
+            session->throttled = 1;
     }
-    head = NULL;
     
-    Book bookData;
-    Book* lastNode = NULL;
+    memmove(session->input, session->input + start, session->inputLength - start);
+    session->inputLength -= start;
     
-    while (fread(&bookData, sizeof(Book), 1, file)) {
-        Book* newBook = (Book*)malloc(sizeof(Book));
-        if (!newBook) {
-            printf("Memory allocation failed!\n");
+    if (sessionAcceptsInput(session) && session->inputLength == sizeof(session->input)) {
+        appendListing(&session->output, "ERR line too long\n");
+        return 0;
+    }
+    return 1;
+}
+
+int serviceSession(ClientSession* session) {
+    do {
+        if (!processSessionInput(session))
+            session->closing = 1;
+        if (!flushSession(session))
+            return 0;
+    } while (sessionAcceptsInput(session) && 
+             memchr(session->input, '\n', session->inputLength));
+    
+    if (session->closing && !session->output.length)
+        return 0;
+    return session->output.length <= SERVER_OUTPUT_LIMIT;
+}
+
+void resumeDelayedSessions(int epollFd) {
+    long long now = monotonicMillis();
+    ClientSession** link = &delayedSessions;
+    
+    while (*link) {
+        ClientSession* session = *link;
+        if (session->resumeAt > now) {
+            link = &session->nextDelayed;
             continue;
         }
         
-        *newBook = bookData;
-        newBook->next = NULL;
-        
-        if (lastNode) {
-            lastNode->next = newBook;
-            lastNode = newBook;
-        } else {
-            head = newBook;
-            lastNode = newBook;
+        *link = session->nextDelayed;
+        session->resumeAt = 0;
+        if (!serviceSession(session)) {
+            closeSession(epollFd, session);
+            continue;
         }
+        updateSessionEvents(epollFd, session);
     }
-    
-    fclose(file);
 }
 
-void loadBorrowRecordsFromFile() {
-    FILE* file = fopen(BORROW_FILE, "rb");
-    if (!file) {
-        return;
-    }
-    
-    BorrowRecord *temp = recordHead, *next;
-    while (temp) {
-        next = temp->next;
-        free(temp);
-        temp = next;
+int nextTimerTimeout() {
+    if (!delayedSessions)
+        return -1;
+    
+    long long earliest = delayedSessions->resumeAt;
+    for (ClientSession* session = delayedSessions->nextDelayed; session; session = session->nextDelayed) {
+        if (session->resumeAt < earliest)
+            earliest = session->resumeAt;
     }
-    recordHead = NULL;
-    
-    BorrowRecord recordData;
-    BorrowRecord* lastNode = NULL;
     
-    while (fread(&recordData, sizeof(BorrowRecord), 1, file)) {
-        BorrowRecord* newRecord = (BorrowRecord*)malloc(sizeof(BorrowRecord));
-        if (!newRecord) {
-            printf("Memory allocation failed!\n");
+    long long wait = earliest - monotonicMillis();
+    return wait < 0 ? 0 : (int)wait;
+}
+
+void acceptClients(int epollFd, int listenFd) {
+    while (1) {
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+        
+        ClientSession* session = (ClientSession*)calloc(1, sizeof(ClientSession));
+        if (!session) {
+            close(fd);
             continue;
         }
+        session->fd = fd;
+        session->userId = -1;
         
-        *newRecord = recordData;
-        newRecord->next = NULL;
+        struct ucred peer;
+        socklen_t peerLength = sizeof(peer);
+        connectionSerial++;
+        if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &peerLength) == 0)
+            snprintf(session->clientKey, sizeof(session->clientKey), "pid:%d#%lu", (int)peer.pid, connectionSerial);
+        else
+            snprintf(session->clientKey, sizeof(session->clientKey), "conn#%lu", connectionSerial);
         
-        if (lastNode) {
-            lastNode->next = newRecord;
-            lastNode = newRecord;
-        } else {
-            recordHead = newRecord;
-            lastNode = newRecord;
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.ptr = session;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            free(session);
+            continue;
+        }
+    }
+}
+
+void handleSessionEvent(int epollFd, ClientSession* session, unsigned int events) {
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        closeSession(epollFd, session);
+        return;
+    }
+    
+    if ((events & EPOLLIN) && session->inputLength < sizeof(session->input)) {
+        ssize_t received = recv(session->fd, session->input + session->inputLength, 
+                                sizeof(session->input) - session->inputLength, 0);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR)) {
+            closeSession(epollFd, session);
+            return;
         }
+        if (received > 0)
+            session->inputLength += received;
     }
     
-    fclose(file);
+    if (!serviceSession(session)) {
+        closeSession(epollFd, session);
+        return;
+    }
+    updateSessionEvents(epollFd, session);
 }
 
-void cleanupMemory() {
-    Book *bookTemp = head, *bookNext;
-    while (bookTemp) {
-        bookNext = bookTemp->next;
-        free(bookTemp);
-        bookTemp = bookNext;
+int runServer(const char* socketPath) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        printf("Error: Socket path is too long.\n");
+        return 1;
     }
+    strcpy(address.sun_path, socketPath);
     
-    User *userTemp = userHead, *userNext;
-    while (userTemp) {
-        userNext = userTemp->next;
-        free(userTemp);
-        userTemp = userNext;
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        printf("Error: Could not create server socket.\n");
+        return 1;
     }
     
-    BorrowRecord *recordTemp = recordHead, *recordNext;
-    while (recordTemp) {
-        recordNext = recordTemp->next;
-        free(recordTemp);
-        recordTemp = recordNext;
+    unlink(socketPath);
+    if (bind(listenFd, (struct sockaddr*)&address, sizeof(address)) < 0 || 
+        listen(listenFd, SOMAXCONN) < 0) {
+        printf("Error: Could not listen on %s.\n", socketPath);
+        close(listenFd);
+        return 1;
     }
+    
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) < 0) {
+        printf("Error: Could not start event loop.\n");
+        close(listenFd);
+        return 1;
+    }
+    
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    printf("Serving branch '%s' on %s\n", branchName, socketPath);
+    fflush(stdout);
+    
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (serverRunning) {
+        int ready = epoll_wait(epollFd, events, SERVER_MAX_EVENTS, nextTimerTimeout());
+        if (ready < 0 && errno != EINTR)
+            break;
+        
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.ptr == NULL)
+                acceptClients(epollFd, listenFd);
+            else
+                handleSessionEvent(epollFd, (ClientSession*)events[i].data.ptr, events[i].events);
+        }
+        resumeDelayedSessions(epollFd);
+    }
+    
+    close(epollFd);
+    close(listenFd);
+    unlink(socketPath);
+    return 0;
 }
+#endif
 
 void initializeProgramData() {
     loadUsersFromFile();
+    recountUserTypes();
     loadBooksFromFile();
     loadBorrowRecordsFromFile();
+    replayLoanJournal();
+    loadLoanHistoryFromFile();
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     int choice;
+    const char* socketPath = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--serve") == 0) {
+            if (i + 1 >= argc) {
+                printf("Usage: %s [branch] --serve <socket path>\n", argv[0]);
+                return 1;
+            }
+            socketPath = argv[++i];
+        } else if (!selectBranch(argv[i])) {
+            printf("Invalid branch name '%s'. Start with a letter or digit, then use letters, digits, '_' or '-'.\n", argv[i]);
+            return 1;
+        }
+    }
     
     initializeProgramData();
     
+    if (socketPath) {
+#ifdef __linux__
+        int status = runServer(socketPath);
+        checkpointLibraryData();
+        cleanupMemory();
+        return status;
+#else
+        printf("Server mode is only available on Linux.\n");
+        return 1;
+#endif
+    }
+    
     while (1) {
         if (loggedInUserId == -1) {
             if (!loginUser()) {
@@ -834,12 +3929,54 @@ int main() {
                 case 10:
                     clearScreen();
                     printf("\nThank you for using the Library System. Goodbye!\n");
-                    saveUsersToFile();
-                    saveBooksToFile();
-                    saveBorrowRecordsToFile();
+                    checkpointLibraryData();
                     cleanupMemory();
                     return 0;
                     
+                case 11:
+                    if (strcmp(loggedInUserType, "Faculty") == 0) {
+                        clearScreen();
+                        displayMainMenu();
+                        showCirculationReports();
+                    } else {
+                        clearScreen();
+                        displayMainMenu();
+                        printf("\nAccess denied. Only Faculty members can view reports.\n");
+                    }
+                    break;
+                    
+                case 12:
+                    displayNetworkCatalog();
+                    break;
+                    
+                case 13:
+                    searchBooksByText();
+                    break;
+                    
+                case 14:
+                    if (strcmp(loggedInUserType, "Faculty") == 0) {
+                        clearScreen();
+                        displayMainMenu();
+                        backupLibraryData();
+                    } else {
+                        clearScreen();
+                        displayMainMenu();
+                        printf("\nAccess denied. Only Faculty members can back up library data.\n");
+                    }
+                    break;
+                    
+                case 15:
+                    if (strcmp(loggedInUserType, "Faculty") == 0) {
+                        clearScreen();
+                        displayMainMenu();
+                        restoreLibraryData();
+                    } else {
+                        clearScreen();
+                        displayMainMenu();
+                        printf("\nAccess denied. Only Faculty members can restore library data.\n");
+                    }
+                    break;
+                    
                 default:
                     clearScreen();
                     displayMainMenu();